@@ -0,0 +1,115 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/// Benchmark settings                                                        
+struct BenchSettings {
+   // Minimum time spent measuring each case                            
+   ::std::chrono::nanoseconds mBudget = ::std::chrono::milliseconds {200};
+   // Minimum number of runs of each case                               
+   uint32_t mMinRuns = 5;
+   // Most threads to convert with, or all hardware threads if 0        
+   uint32_t mMaxThreads = 0;
+};
+
+/// Terminal resolutions, from the smallest common one, to a big monitor      
+struct Resolution {
+   uint32_t mWidth;
+   uint32_t mHeight;
+};
+
+constexpr Resolution Resolutions[] {
+   {80, 24}, {160, 48}, {240, 72}, {320, 96}, {400, 120}
+};
+
+
+///                                                                           
+///   A single JSON object, built field by field                              
+///                                                                           
+class JsonRecord {
+   ::std::string mText;
+
+   void Name(const char* name) {
+      if (not mText.empty())
+         mText += ", ";
+      mText += '"';
+      mText += name;
+      mText += "\": ";
+   }
+
+public:
+   JsonRecord& Add(const char* name, const ::std::string& value) {
+      Name(name);
+      mText += '"';
+      mText += value;
+      mText += '"';
+      return *this;
+   }
+
+   JsonRecord& Add(const char* name, const char* value) {
+      return Add(name, ::std::string {value});
+   }
+
+   JsonRecord& Add(const char* name, double value) {
+      Name(name);
+      mText += ::std::to_string(value);
+      return *this;
+   }
+
+   JsonRecord& Add(const char* name, uint64_t value) {
+      Name(name);
+      mText += ::std::to_string(value);
+      return *this;
+   }
+
+   JsonRecord& Add(const char* name, uint32_t value) {
+      return Add(name, static_cast<uint64_t>(value));
+   }
+
+   ::std::string Str() const {
+      return "{" + mText + "}";
+   }
+};
+
+using JsonRecords = ::std::vector<JsonRecord>;
+
+
+/// Run a case repeatedly, until both the time budget and the minimum number  
+/// of runs are exhausted                                                     
+///   @param settings - the budget                                            
+///   @param f - the case, called with the index of the run                   
+///   @return average nanoseconds per run                                     
+template<class F>
+double Measure(const BenchSettings& settings, F&& f) {
+   using Clock = ::std::chrono::steady_clock;
+
+   // Warm up caches and lazily built tables                            
+   f(0u);
+
+   uint32_t runs = 0;
+   const auto start = Clock::now();
+   auto elapsed = Clock::duration {};
+   while (runs < settings.mMinRuns or elapsed < settings.mBudget) {
+      f(++runs);
+      elapsed = Clock::now() - start;
+   }
+
+   return static_cast<double>(
+      ::std::chrono::duration_cast<::std::chrono::nanoseconds>(elapsed).count()
+   ) / runs;
+}
+
+void BenchPipeline(const BenchSettings&, JsonRecords&);
+void BenchEncoder(const BenchSettings&, JsonRecords&);
+void BenchPool(const BenchSettings&, JsonRecords&);
+void BenchHierarchy(const BenchSettings&, JsonRecords&);
@@ -0,0 +1,124 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Bench.hpp"
+#include "../source/Encoder.hpp"
+#include "../source/Palette.hpp"
+#include <random>
+
+using namespace Kernels;
+
+
+/// Number of distinct frames each content cycles through                     
+constexpr uint32_t FrameCount = 16;
+
+/// Kinds of content, from the cheapest to the most expensive to output       
+enum class Content {
+   Static,     // The same frame over and over
+   Scrolling,  // Text and colors moving up by a row each frame
+   Noise       // Every cell changes every frame
+};
+
+constexpr const char* ContentNames[] {"static", "scrolling", "noise"};
+
+
+/// Generate the frames of a content                                          
+///   @param content - the content                                            
+///   @param w, h - size of the frames                                        
+///   @param glyphs - table to intern graphemes in                            
+///   @return the frames                                                      
+auto Generate(Content content, uint32_t w, uint32_t h, GlyphTable& glyphs) {
+   ::std::mt19937 rng {7};
+   const GlyphID text[] {
+      glyphs.Intern("a"), glyphs.Intern("b"), glyphs.Intern("c"),
+      glyphs.Intern(" "), glyphs.Intern("│"), glyphs.Intern("─")
+   };
+
+   ::std::vector<CellBuffer> frames(FrameCount);
+   for (uint32_t f = 0; f < FrameCount; ++f) {
+      auto& cells = frames[f];
+      cells.Resize(w, h);
+      cells.Clear();
+
+      for (uint32_t y = 0; y < h; ++y) {
+         for (uint32_t x = 0; x < w; ++x) {
+            const auto i = cells.RowOffset(y) + x;
+            switch (content) {
+            case Content::Static:
+               cells.mBg[i] = Pack(x * 255 / w, y * 255 / h, 64);
+               cells.mFg[i] = Pack(220, 220, 220);
+               cells.mGlyphs[i] = text[(x * 7 + y * 3) % ::std::size(text)];
+               break;
+            case Content::Scrolling: {
+               // Lines of text, with a background gradient, that       
+               // scroll with them                                      
+               const auto line = y + f;
+               cells.mBg[i] = Pack(0, 0, (line * 16) & 255);
+               cells.mFg[i] = Pack(200, 200, 200);
+               cells.mGlyphs[i] = (x + line * 5) % 11 < 8
+                  ? text[(x * 13 + line * 7) % 3]
+                  : GlyphTable::Space;
+               break;
+            }
+            case Content::Noise:
+               cells.mBg[i] = rng() & 0xFFFFFF;
+               cells.mFg[i] = rng() & 0xFFFFFF;
+               cells.mGlyphs[i] = text[rng() % ::std::size(text)];
+               break;
+            }
+         }
+      }
+   }
+   return frames;
+}
+
+/// Measure output bytes and encoding time per frame, for different contents  
+/// and color depths                                                          
+///   @param settings - the time budget                                       
+///   @param results - [out] one record per case                              
+void BenchEncoder(const BenchSettings& settings, JsonRecords& results) {
+   for (auto resolution : Resolutions) {
+      const auto w = resolution.mWidth;
+      const auto h = resolution.mHeight;
+
+      for (auto content : {Content::Static, Content::Scrolling, Content::Noise}) {
+         for (auto depth : {ColorDepth::TrueColor, ColorDepth::Colors256, ColorDepth::Colors16}) {
+            GlyphTable glyphs;
+            auto frames = Generate(content, w, h, glyphs);
+
+            const Palette palette {depth};
+            for (auto& cells : frames) {
+               palette.Quantize(cells.mBg.data(), static_cast<uint32_t>(cells.GetCount()), 0);
+               palette.Quantize(cells.mFg.data(), static_cast<uint32_t>(cells.GetCount()), 0);
+            }
+
+            Encoder encoder;
+            ::std::string out;
+            encoder.Sync(frames[0]);
+            size_t bytes = 0;
+            size_t encoded = 0;
+
+            const auto ns = Measure(settings, [&](uint32_t run) {
+               const auto& frame = content == Content::Static
+                  ? frames[0] : frames[run % FrameCount];
+               encoder.Encode(frame, glyphs, w, h, out);
+               bytes += out.size();
+               ++encoded;
+            });
+
+            results.push_back(JsonRecord {}
+               .Add("width", w)
+               .Add("height", h)
+               .Add("content", ContentNames[static_cast<int>(content)])
+               .Add("colors", depth == ColorDepth::TrueColor ? "truecolor"
+                            : depth == ColorDepth::Colors256 ? "256" : "16")
+               .Add("ns_per_frame", ns)
+               .Add("bytes_per_frame", static_cast<double>(bytes) / encoded));
+         }
+      }
+   }
+}
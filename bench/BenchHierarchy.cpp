@@ -0,0 +1,50 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Bench.hpp"
+#include "../source/Traits.hpp"
+#include <Langulus/Entity/Thing.hpp>
+
+
+/// Measure creation and update of a headless GUI system with the editor,     
+/// inside hierarchies of different sizes - ten children per Thing. The       
+/// editor mirrors the whole hierarchy when created, and is rendered on       
+/// every update                                                              
+///   @param settings - the time budget                                       
+///   @param results - [out] one record per case                              
+void BenchHierarchy(const BenchSettings& settings, JsonRecords& results) {
+   using Clock = ::std::chrono::steady_clock;
+
+   for (uint32_t things : {10u, 100u, 1'000u, 10'000u, 100'000u}) {
+      auto root = Thing::Root<false>("FTXUI");
+
+      // Grow the hierarchy breadth first                               
+      ::std::vector<Thing*> parents {&root};
+      uint32_t created = 1;
+      for (size_t p = 0; created < things; ++p) {
+         for (int c = 0; c < 10 and created < things; ++c, ++created)
+            parents.push_back(&*parents[p]->CreateChild());
+      }
+
+      const auto start = Clock::now();
+      auto gui = root.CreateUnit<A::UISystem>(
+         Traits::Headless {true}, Traits::Size {Scale2 {160, 48}},
+         Traits::Editor {true}, Traits::KeepAlive {Time {}});
+      root.Update({});
+      const auto createNs = ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+         Clock::now() - start).count();
+
+      const auto updateNs = Measure(settings, [&](uint32_t) {
+         root.Update({});
+      });
+
+      results.push_back(JsonRecord {}
+         .Add("things", things)
+         .Add("create_ns", static_cast<double>(createNs))
+         .Add("ns_per_update", updateNs));
+   }
+}
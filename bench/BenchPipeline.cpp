@@ -0,0 +1,125 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Bench.hpp"
+#include "../source/Kernels.hpp"
+#include "../source/Traits.hpp"
+#include <Langulus/Entity/Thing.hpp>
+#include <Langulus/Math/Color.hpp>
+#include <Langulus/Verbs/Associate.hpp>
+#include <random>
+
+using namespace Kernels;
+
+
+/// Layouts of frames that can be drawn through reflection                    
+enum class Layout {
+   Background,
+   HalfBlocks,
+   Colors,
+   Native
+};
+
+constexpr const char* LayoutNames[] {"Background", "HalfBlocks", "Colors", "Native"};
+
+/// Color depths that are measured                                            
+struct Depth {
+   const char* mName;
+   uint32_t mColors;
+   bool mDither;
+};
+
+constexpr Depth Depths[] {
+   {"truecolor",  0,   false},
+   {"256",        256, false},
+   {"256-dither", 256, true},
+   {"16",         16,  false},
+};
+
+
+/// Measure GUISystem::Draw, by associating frames with a headless system,    
+/// the way renderer modules draw - RGBA float colors go through conversion   
+/// and quantization, native cells are copied. Every row changes in every     
+/// frame, so no row is ever skipped                                          
+///   @param settings - the time budget                                       
+///   @param results - [out] one record per case                              
+void BenchPipeline(const BenchSettings& settings, JsonRecords& results) {
+   ::std::mt19937 rng {42};
+   ::std::uniform_real_distribution<float> unit {0.f, 1.f};
+   const auto random = [&] {
+      return Math::RGBAf {unit(rng), unit(rng), unit(rng), 1.f};
+   };
+   const uint32_t symbols[] {' ', '#', '+', '-', '.', 0x2588, 0x2593, 0x2592};
+
+   for (auto resolution : Resolutions) {
+      const auto w = resolution.mWidth;
+      const auto h = resolution.mHeight;
+
+      for (auto layout : {Layout::Background, Layout::HalfBlocks, Layout::Colors, Layout::Native}) {
+         for (auto& depth : Depths) {
+            // Native cells are never quantized                         
+            if (layout == Layout::Native and depth.mColors)
+               continue;
+
+            auto root = Thing::Root<false>("FTXUI");
+            auto gui = root.CreateUnit<A::UISystem>(
+               Traits::Headless {true}, Traits::Size {Scale2 {w, h}},
+               Traits::Colors {depth.mColors}, Traits::Dither {depth.mDither},
+               Traits::HalfBlocks {layout == Layout::HalfBlocks});
+
+            // Half blocks pack two rows of pixels in each row of cells 
+            const auto rows = layout == Layout::HalfBlocks ? h * 2 : h;
+            TMany<Math::RGBAf> fg, bg;
+            TMany<uint32_t> glyphs, packedFg, packedBg;
+            Many channels;
+            if (layout == Layout::Native) {
+               for (uint32_t i = 0; i < w * rows; ++i) {
+                  glyphs << symbols[rng() % ::std::size(symbols)];
+                  packedFg << Pack(rng() & 255, rng() & 255, rng() & 255);
+                  packedBg << Pack(rng() & 255, rng() & 255, rng() & 255);
+               }
+               channels << Traits::CellGlyphs {glyphs}
+                        << Traits::CellForeground {packedFg}
+                        << Traits::CellBackground {packedBg};
+            }
+            else {
+               for (uint32_t i = 0; i < w * rows; ++i) {
+                  fg << random();
+                  bg << random();
+               }
+               if (layout == Layout::Colors)
+                  channels << Traits::CellForeground {fg};
+               channels << Traits::CellBackground {bg};
+            }
+
+            const auto ns = Measure(settings, [&](uint32_t run) {
+               // Change a cell in each row, so that all are converted  
+               for (uint32_t y = 0; y < rows; ++y) {
+                  if (layout == Layout::Native)
+                     packedBg[y * w] = run;
+                  else
+                     bg[y * w] = Math::RGBAf {(run & 255) / 255.f, 0.f, 0.f, 1.f};
+               }
+
+               Many cells;
+               cells << Traits::Size {Scale2 {w, rows}} << channels;
+               Verbs::Associate associate {cells};
+               root.Run(associate);
+            });
+
+            results.push_back(JsonRecord {}
+               .Add("width", w)
+               .Add("height", h)
+               .Add("layout", LayoutNames[static_cast<int>(layout)])
+               .Add("colors", depth.mName)
+               .Add("kernel", GetConvertKernel().mName)
+               .Add("ns_per_frame", ns)
+               .Add("mcells_per_s", w * h * 1e3 / ns));
+         }
+      }
+   }
+}
@@ -0,0 +1,91 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Bench.hpp"
+#include "../source/Cells.hpp"
+#include "../source/Palette.hpp"
+#include "../source/WorkPool.hpp"
+#include <algorithm>
+#include <random>
+
+using namespace Kernels;
+
+
+/// Measure how converting in row bands scales with the number of threads,    
+/// on terminals large enough for GUISystem to convert in parallel - bands    
+/// are split the same way GUISystem splits them                              
+///   @param settings - the time budget                                       
+///   @param results - [out] one record per case                              
+void BenchPool(const BenchSettings& settings, JsonRecords& results) {
+   constexpr uint32_t BandCells = 8 * 1024;
+   constexpr Resolution Large[] {{500, 150}, {1000, 300}};
+   const auto& kernel = GetConvertKernel();
+   const ::std::string_view symbols[] {" ", "a", "█", "▓", "▒", "░"};
+   ::std::mt19937 rng {3};
+   ::std::uniform_real_distribution<float> unit {0.f, 1.f};
+
+   // Thread counts to try - powers of two, and all hardware threads,   
+   // unless told otherwise                                             
+   ::std::vector<uint32_t> threads;
+   const auto maximum = settings.mMaxThreads
+      ? settings.mMaxThreads : WorkPool::DefaultWorkers() + 1;
+   for (uint32_t t = 1; t < maximum; t *= 2)
+      threads.push_back(t);
+   threads.push_back(maximum);
+
+   for (auto resolution : Large) {
+      const auto w = resolution.mWidth;
+      const auto h = resolution.mHeight;
+      const auto count = size_t {w} * h;
+      ::std::vector<float> rgba(count * 4);
+      for (auto& c : rgba)
+         c = unit(rng);
+      ::std::vector<::std::string_view> text(count);
+      for (auto& s : text)
+         s = symbols[rng() % ::std::size(symbols)];
+
+      const auto bandRows = ::std::max(BandCells / w, 1u);
+      const auto bands = (h + bandRows - 1) / bandRows;
+      double single = 0;
+
+      for (auto t : threads) {
+         WorkPool pool {t - 1};
+         const Palette palette {ColorDepth::Colors256};
+         GlyphTable glyphs;
+         ::std::vector<GlyphTable::Cache> caches(bands);
+         CellBuffer cells;
+         cells.Resize(w, h);
+
+         const auto ns = Measure(settings, [&](uint32_t) {
+            pool.Run(bands, [&](uint32_t band) {
+               const auto end = ::std::min((band + 1) * bandRows, h);
+               for (auto y = band * bandRows; y < end; ++y) {
+                  const auto offset = cells.RowOffset(y);
+                  const auto bg = cells.mBg.data() + offset;
+                  const auto fg = cells.mFg.data() + offset;
+                  kernel.mFunction(rgba.data() + offset * 4, w, bg, fg);
+                  palette.Quantize(bg, w, y);
+                  palette.Quantize(fg, w, y);
+                  for (uint32_t x = 0; x < w; ++x)
+                     cells.mGlyphs[offset + x] = glyphs.Intern(text[offset + x], caches[band]);
+               }
+            });
+         });
+
+         if (t == 1)
+            single = ns;
+
+         results.push_back(JsonRecord {}
+            .Add("width", w)
+            .Add("height", h)
+            .Add("threads", t)
+            .Add("bands", bands)
+            .Add("ns_per_frame", ns)
+            .Add("speedup", single / ns));
+      }
+   }
+}
@@ -0,0 +1,70 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Bench.hpp"
+#include <Langulus/Entity/Thing.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+LANGULUS_RTTI_BOUNDARY(RTTI::MainBoundary)
+using namespace Langulus;
+
+
+/// Write the results of a section as a JSON array                            
+///   @param out - the stream to write to                                     
+///   @param name - name of the section                                       
+///   @param records - the results                                            
+///   @param last - whether this is the last section                          
+void WriteSection(
+   ::std::ostream& out, const char* name, const JsonRecords& records, bool last
+) {
+   out << "  \"" << name << "\": [\n";
+   for (size_t i = 0; i < records.size(); ++i) {
+      out << "    " << records[i].Str();
+      out << (i + 1 < records.size() ? ",\n" : "\n");
+   }
+   out << (last ? "  ]\n" : "  ],\n");
+}
+
+/// Run all benchmarks, and write the results as JSON                         
+///   Usage: LangulusModFTXUIBench [--quick] [--threads N] [output.json]      
+/// Results go to the standard output, unless a file is given. The quick      
+/// mode runs each case only a few times, for smoke testing. The pool is      
+/// measured with up to N threads, all hardware threads by default            
+int main(int argc, char** argv) {
+   BenchSettings settings;
+   const char* path = nullptr;
+   for (int i = 1; i < argc; ++i) {
+      if (0 == ::std::strcmp(argv[i], "--quick")) {
+         settings.mBudget = {};
+         settings.mMinRuns = 1;
+      }
+      else if (0 == ::std::strcmp(argv[i], "--threads") and i + 1 < argc)
+         settings.mMaxThreads = static_cast<uint32_t>(::std::atoi(argv[++i]));
+      else path = argv[i];
+   }
+
+   JsonRecords pipeline, encoder, pool, hierarchy;
+   BenchPipeline(settings, pipeline);
+   BenchEncoder(settings, encoder);
+   BenchPool(settings, pool);
+   BenchHierarchy(settings, hierarchy);
+
+   ::std::ofstream file;
+   if (path)
+      file.open(path);
+   auto& out = path ? static_cast<::std::ostream&>(file) : ::std::cout;
+   out << "{\n";
+   WriteSection(out, "pipeline", pipeline, false);
+   WriteSection(out, "encoder", encoder, false);
+   WriteSection(out, "pool", pool, false);
+   WriteSection(out, "hierarchy", hierarchy, true);
+   out << "}\n";
+   return 0;
+}
@@ -0,0 +1,171 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Cells.hpp"
+#include <algorithm>
+
+
+/// Create the table, with all ASCII characters already interned              
+GlyphTable::GlyphTable() {
+   mChunks[0] = ::std::make_unique<::std::string[]>(ChunkSize);
+   for (uint32_t c = 1; c < 128; ++c)
+      mChunks[0][c] = static_cast<char>(c);
+   mCount.store(128, ::std::memory_order_release);
+}
+
+/// Get the identifier of a grapheme, interning it if not interned yet        
+/// Uses the table's own cache, so not to be called from multiple threads     
+///   @param glyph - the grapheme to intern                                   
+///   @return the identifier                                                  
+auto GlyphTable::Intern(::std::string_view glyph) -> GlyphID {
+   return Intern(glyph, mCache);
+}
+
+/// Get the identifier of a grapheme, interning it if not interned yet        
+/// When the table is full, graphemes that aren't interned become Unknown     
+/// Thread-safe, as long as each thread provides its own cache                
+///   @param glyph - the grapheme to intern                                   
+///   @param cache - the cache to use                                         
+///   @return the identifier                                                  
+auto GlyphTable::Intern(::std::string_view glyph, Cache& cache) -> GlyphID {
+   // ASCII is mapped directly                                          
+   if (glyph.empty())
+      return Empty;
+   if (glyph.size() == 1 and static_cast<unsigned char>(glyph[0]) < 128)
+      return static_cast<GlyphID>(glyph[0]);
+
+   // Most symbols come from the same place every frame, but contents   
+   // at that place might have changed, so compare them too             
+   auto& cached = cache.mEntries[(reinterpret_cast<uintptr_t>(glyph.data()) >> 3) % ::std::size(cache.mEntries)];
+   if (cached.mData == glyph.data() and Get(cached.mID) == glyph)
+      return cached.mID;
+
+   ::std::unique_lock lock {mMutex};
+   GlyphID id;
+   const auto found = mLookup.find(glyph);
+   if (found != mLookup.end())
+      id = found->second;
+   else {
+      const auto count = mCount.load(::std::memory_order_relaxed);
+      if (count >= Capacity)
+         return Unknown;
+
+      auto& chunk = mChunks[count / ChunkSize];
+      if (not chunk)
+         chunk = ::std::make_unique<::std::string[]>(ChunkSize);
+
+      auto& interned = chunk[count % ChunkSize];
+      interned = glyph;
+      id = static_cast<GlyphID>(count);
+      mLookup.emplace(interned, id);
+      mCount.store(count + 1, ::std::memory_order_release);
+   }
+
+   lock.unlock();
+   cached = {glyph.data(), id};
+   return id;
+}
+
+/// Drop the graphemes that aren't used by any of the given cells, and        
+/// compact the rest, so that their slots can be handed out again             
+/// The cells are rewritten with the new identifiers. Not thread-safe -       
+/// nothing else may use the table meanwhile, and any identifier that isn't   
+/// in the cells is invalid afterwards. Caches remain usable                  
+///   @param cells - the cells whose graphemes are kept                       
+///   @return the number of dropped graphemes                                 
+auto GlyphTable::Recycle(::std::span<CellBuffer* const> cells) -> uint32_t {
+   const auto count = mCount.load(::std::memory_order_relaxed);
+   if (count <= 128)
+      return 0;
+
+   // Mark the graphemes in use - ASCII is never moved                  
+   ::std::vector<GlyphID> remap(count, Empty);
+   for (auto buffer : cells) {
+      for (auto id : buffer->mGlyphs) {
+         if (id >= 128 and id < count)
+            remap[id] = Unknown;
+      }
+   }
+
+   // Move the kept strings down, reusing the capacity of the dropped   
+   // ones - lookup keys view into the strings, so it's rebuilt         
+   mLookup.clear();
+   uint32_t kept = 128;
+   for (uint32_t id = 128; id < count; ++id) {
+      auto& from = mChunks[id / ChunkSize][id % ChunkSize];
+      if (not remap[id]) {
+         from.clear();
+         continue;
+      }
+
+      auto& to = mChunks[kept / ChunkSize][kept % ChunkSize];
+      if (&to != &from) {
+         to.swap(from);
+         from.clear();
+      }
+
+      remap[id] = static_cast<GlyphID>(kept);
+      mLookup.emplace(to, remap[id]);
+      ++kept;
+   }
+
+   for (auto buffer : cells) {
+      for (auto& id : buffer->mGlyphs) {
+         if (id >= 128)
+            id = id < count ? remap[id] : Unknown;
+      }
+   }
+
+   // Cached entries are checked against the strings, and the dropped   
+   // ones are empty, so stale entries never match                      
+   mCount.store(kept, ::std::memory_order_release);
+   return count - kept;
+}
+
+/// Get an interned grapheme                                                  
+///   @param id - the identifier, as returned by Intern                       
+///   @return the grapheme                                                    
+auto GlyphTable::Get(GlyphID id) const noexcept -> ::std::string_view {
+   return mChunks[id / ChunkSize][id % ChunkSize];
+}
+
+/// Get the number of interned graphemes, including ASCII                     
+auto GlyphTable::GetCount() const noexcept -> uint32_t {
+   return mCount.load(::std::memory_order_acquire);
+}
+
+/// Resize the buffer, keeping the already allocated capacity                 
+/// Growing reserves some headroom, so that a terminal that grows a few cells 
+/// at a time, while being resized, doesn't reallocate on every frame         
+/// Contents are undefined after resizing                                     
+///   @param width - the new width, in cells                                  
+///   @param height - the new height, in cells                                
+void CellBuffer::Resize(uint32_t width, uint32_t height) {
+   mWidth = width;
+   mHeight = height;
+   const auto count = GetCount();
+   if (count > mGlyphs.capacity()) {
+      const auto capacity = count + count / 2;
+      mGlyphs.reserve(capacity);
+      mFg.reserve(capacity);
+      mBg.reserve(capacity);
+      mStyles.reserve(capacity);
+   }
+
+   mGlyphs.resize(count);
+   mFg.resize(count);
+   mBg.resize(count);
+   mStyles.resize(count);
+}
+
+/// Fill all cells with black spaces                                          
+void CellBuffer::Clear() noexcept {
+   ::std::fill(mGlyphs.begin(), mGlyphs.end(), GlyphTable::Space);
+   ::std::fill(mFg.begin(), mFg.end(), Kernels::RGB8 {});
+   ::std::fill(mBg.begin(), mBg.end(), Kernels::RGB8 {});
+   ::std::fill(mStyles.begin(), mStyles.end(), uint8_t {});
+}
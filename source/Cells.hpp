@@ -0,0 +1,127 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Kernels.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+/// Identifier of an interned grapheme                                        
+using GlyphID = uint16_t;
+
+struct CellBuffer;
+
+/// Style bits of a cell                                                      
+enum CellStyle : uint8_t {
+   CellBold             = 1 << 0,
+   CellDim              = 1 << 1,
+   CellItalic           = 1 << 2,
+   CellUnderlined       = 1 << 3,
+   CellUnderlinedDouble = 1 << 4,
+   CellBlink            = 1 << 5,
+   CellInverted         = 1 << 6,
+   CellStrikethrough    = 1 << 7,
+};
+
+
+///                                                                           
+///   Grapheme intern table                                                   
+///                                                                           
+///   Maps graphemes to compact identifiers, so that cells don't have to own  
+/// strings. Identifiers below 128 are ASCII characters, and never touch the  
+/// lookup map. Interned strings are moved only when recycling, so that views 
+/// returned by Get remain valid until then, and can be read by another       
+/// thread, once the identifier was handed over to it.                        
+///   Several threads may intern at the same time, as long as each of them    
+/// uses its own cache.                                                       
+///   Once the table fills up, graphemes that aren't interned become Unknown, 
+/// until the table is recycled - the graphemes still used by some cells are  
+/// kept and compacted, and all others are dropped, so that their slots can   
+/// be handed out again.                                                      
+///                                                                           
+class GlyphTable {
+public:
+   /// Direct mapped cache, keyed by the address of the incoming view,        
+   /// because renderers usually draw from a fixed set of symbols             
+   struct Cache {
+      struct Entry {
+         const char* mData {};
+         GlyphID mID {};
+      };
+      Entry mEntries[64] {};
+   };
+
+   static constexpr GlyphID Empty = 0;
+   static constexpr GlyphID Space = ' ';
+   static constexpr GlyphID Unknown = '?';
+   static constexpr uint32_t ChunkSize = 256;
+   static constexpr uint32_t Capacity = 65536;
+
+   GlyphTable();
+   GlyphTable(const GlyphTable&) = delete;
+
+   auto Intern(::std::string_view) -> GlyphID;
+   auto Intern(::std::string_view, Cache&) -> GlyphID;
+   auto Recycle(::std::span<CellBuffer* const>) -> uint32_t;
+   auto Get(GlyphID) const noexcept -> ::std::string_view;
+   auto GetCount() const noexcept -> uint32_t;
+
+   /// Get the table's own cache, for use on the thread that owns the table   
+   Cache& GetCache() noexcept {
+      return mCache;
+   }
+
+private:
+   // Interned strings, in chunks that never move                       
+   ::std::unique_ptr<::std::string[]> mChunks[Capacity / ChunkSize];
+   // Number of interned strings, published after each new string       
+   ::std::atomic<uint32_t> mCount;
+   // Lookup for strings that aren't ASCII, keys view into mChunks      
+   ::std::unordered_map<::std::string_view, GlyphID> mLookup;
+   // Guards the lookup, and adding strings                             
+   ::std::mutex mMutex;
+   // Cache for interning without providing one                         
+   Cache mCache;
+};
+
+
+///                                                                           
+///   Compact cell buffer                                                     
+///                                                                           
+///   A structure of arrays, that holds a glyph identifier, packed colors     
+/// and style bits for each cell - about 11 bytes per cell, instead of the    
+/// few dozen bytes of an ftxui::Pixel with its own string. Resizing keeps    
+/// the capacity, so it never reallocates when shrinking.                     
+///                                                                           
+struct CellBuffer {
+   uint32_t mWidth {};
+   uint32_t mHeight {};
+   ::std::vector<GlyphID> mGlyphs;
+   ::std::vector<Kernels::RGB8> mFg;
+   ::std::vector<Kernels::RGB8> mBg;
+   ::std::vector<uint8_t> mStyles;
+
+   void Resize(uint32_t, uint32_t);
+   void Clear() noexcept;
+
+   /// Get the number of cells                                                
+   size_t GetCount() const noexcept {
+      return size_t {mWidth} * mHeight;
+   }
+
+   /// Get the offset of the first cell in a row                              
+   size_t RowOffset(uint32_t y) const noexcept {
+      return size_t {mWidth} * y;
+   }
+};
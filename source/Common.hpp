@@ -6,8 +6,12 @@
 /// SPDX-License-Identifier: GPL-3.0-or-later                                 
 ///                                                                           
 #pragma once
-#include <Langulus/UI.hpp>
+#include "Traits.hpp"
+#include "Cells.hpp"
 #include <Langulus/Platform.hpp>
+#include <Langulus/Logger.hpp>
+#include <array>
+#include <utility>
 
 using namespace Langulus;
 
@@ -15,6 +19,36 @@ struct GUI;
 struct GUISystem;
 struct GUIItem;
 
+/// Cell style bits for every combination of emphasis bits, so that styles    
+/// are converted with a single lookup, instead of testing each flag          
+inline constexpr auto EmphasisStyles = [] {
+   constexpr ::std::pair<Logger::Emphasis, CellStyle> map[] {
+      {Logger::Emphasis::bold,          CellBold},
+      {Logger::Emphasis::faint,         CellDim},
+      {Logger::Emphasis::italic,        CellItalic},
+      {Logger::Emphasis::underline,     CellUnderlined},
+      {Logger::Emphasis::blink,         CellBlink},
+      {Logger::Emphasis::reverse,       CellInverted},
+      {Logger::Emphasis::strikethrough, CellStrikethrough}
+   };
+
+   ::std::array<uint8_t, 256> table {};
+   for (unsigned e = 0; e < table.size(); ++e) {
+      for (auto [emphasis, style] : map) {
+         if (e & static_cast<uint8_t>(emphasis))
+            table[e] |= style;
+      }
+   }
+   return table;
+}();
+
+/// Convert emphasis to cell style bits                                       
+///   @param emphasis - the emphasis                                          
+///   @return the style bits                                                  
+constexpr uint8_t ToCellStyle(Logger::Emphasis emphasis) noexcept {
+   return EmphasisStyles[static_cast<uint8_t>(emphasis)];
+}
+
 #if 0
    #define VERBOSE_GUI(...)      Logger::Verbose(Self(), __VA_ARGS__)
    #define VERBOSE_GUI_TAB(...)  const auto tab = Logger::VerboseTab(Self(), __VA_ARGS__)
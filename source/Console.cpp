@@ -0,0 +1,206 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Console.hpp"
+#include <algorithm>
+
+
+/// Create a console                                                          
+///   @param parser - parses submitted commands                               
+///   @param fragments - capacity of the result queue, in fragments           
+Console::Console(Parser parser, uint32_t fragments)
+   : mParser {::std::move(parser)}
+   , mOutput {fragments} {}
+
+/// Cancel everything                                                         
+Console::~Console() {
+   Cancel();
+}
+
+/// Parse a command, and queue it for execution                               
+/// Commands that fail to parse are never queued                              
+///   @param command - the command                                            
+void Console::Submit(::std::string_view command) {
+   auto script = Parse(::std::string {command});
+   if (not script)
+      return;
+
+   ::std::scoped_lock lock {mMutex};
+   mReady.push_back({::std::move(script), mCancels.load(::std::memory_order_acquire)});
+   ++mQueued;
+   mBusy.store(true, ::std::memory_order_release);
+}
+
+/// Cancel the running command, along with all waiting ones                   
+/// The running one stops before its next step                                
+void Console::Cancel() {
+   ::std::scoped_lock lock {mMutex};
+   mQueued -= static_cast<uint32_t>(mReady.size());
+   mReady.clear();
+   mCancels.fetch_add(1, ::std::memory_order_acq_rel);
+   mBusy.store(mQueued != 0, ::std::memory_order_release);
+}
+
+/// Write a result line - scripts call this from their steps                  
+///   @param text - the text, split in lines if multiline                     
+///   @param color - color of the text                                        
+///   @param style - style bits of the text                                   
+void Console::Write(::std::string_view text, Kernels::RGB8 color, uint8_t style) noexcept {
+   mOutput.Push(LogQueue::Style, {}, color, style);
+   while (true) {
+      const auto end = text.find('\n');
+      mOutput.Push(LogQueue::Text, text.substr(0, end));
+      mOutput.Push(LogQueue::NewLine);
+      if (end == ::std::string_view::npos)
+         break;
+      text.remove_prefix(end + 1);
+   }
+}
+
+/// Get a command from the history                                            
+///   @param age - zero for the most recent command                           
+///   @param out - [out] the command                                          
+///   @return false if the history isn't that long                            
+bool Console::GetHistory(uint32_t age, ::std::string& out) const {
+   ::std::scoped_lock lock {mMutex};
+   if (age >= mHistory.size())
+      return false;
+   out = mHistory[age].mText;
+   return true;
+}
+
+/// Get the usage statistics                                                  
+///   @return the statistics                                                  
+auto Console::GetStats() const -> Stats {
+   ::std::scoped_lock lock {mMutex};
+   return mStats;
+}
+
+/// Parse, or reuse the parse result of, a command                            
+///   @param command - the command                                            
+///   @return the parsed command, or nullptr if it failed to parse            
+auto Console::Parse(const ::std::string& command) -> ::std::shared_ptr<Script> {
+   Write("> " + command, EchoColor);
+
+   // Reuse the parse result, if the command was run recently, and      
+   // move it to the front of the history                               
+   ::std::shared_ptr<Script> script;
+   {
+      ::std::scoped_lock lock {mMutex};
+      const auto found = ::std::find_if(mHistory.begin(), mHistory.end(),
+         [&](const Entry& entry) { return entry.mText == command; });
+      if (found != mHistory.end()) {
+         script = found->mScript;
+         mHistory.erase(found);
+         if (script)
+            ++mStats.mReused;
+      }
+   }
+
+   if (not script) {
+      try {
+         script = mParser(command);
+      }
+      catch (const ::std::exception& e) {
+         Write(e.what(), ErrorColor);
+      }
+      catch (...) {
+         Write("Unable to parse command", ErrorColor);
+      }
+
+      ::std::scoped_lock lock {mMutex};
+      ++mStats.mParsed;
+   }
+
+   // Commands are remembered even if they failed to parse, so they     
+   // can be fixed up from the history                                  
+   ::std::scoped_lock lock {mMutex};
+   mHistory.push_front({command, script});
+   if (mHistory.size() > HistorySize)
+      mHistory.pop_back();
+   return script;
+}
+
+/// Run parsed commands step by step, until they're all done, or the budget   
+/// runs out - at least one step is run, if there's any to run                
+/// Call it on the thread that owns whatever the commands touch, usually      
+/// once per frame, on the main thread                                        
+///   @param budget - time to spend running steps                             
+///   @return the number of steps that were run                               
+uint32_t Console::Execute(::std::chrono::nanoseconds budget) {
+   const auto deadline = ::std::chrono::steady_clock::now() + budget;
+   uint32_t ran = 0;
+   do {
+      if (not mScript and not Next())
+         break;
+
+      if (IsCancelled()) {
+         Write("Cancelled", ErrorColor);
+         {
+            ::std::scoped_lock lock {mMutex};
+            ++mStats.mCancelled;
+         }
+         Retire();
+         continue;
+      }
+
+      if (mStep >= mScript->GetSteps()) {
+         Retire();
+         continue;
+      }
+
+      try {
+         mScript->Run(mStep++, *this);
+         ++ran;
+      }
+      catch (const ::std::exception& e) {
+         Write(e.what(), ErrorColor);
+         Retire();
+      }
+      catch (...) {
+         Write("Command failed", ErrorColor);
+         Retire();
+      }
+   } while (::std::chrono::steady_clock::now() < deadline);
+   return ran;
+}
+
+/// Pick up the next parsed command, and prepare it for running               
+///   @return false if there's nothing to run                                 
+bool Console::Next() {
+   while (true) {
+      {
+         ::std::scoped_lock lock {mMutex};
+         if (mReady.empty())
+            return false;
+         mScript = ::std::move(mReady.front().mScript);
+         mRunning = mReady.front().mGeneration;
+         mReady.pop_front();
+      }
+
+      mStep = 0;
+      try {
+         mScript->Prepare();
+         return true;
+      }
+      catch (const ::std::exception& e) {
+         Write(e.what(), ErrorColor);
+      }
+      catch (...) {
+         Write("Unable to prepare command", ErrorColor);
+      }
+      Retire();
+   }
+}
+
+/// Release the running command, whether it finished or not                   
+void Console::Retire() {
+   mScript.reset();
+   ::std::scoped_lock lock {mMutex};
+   if (--mQueued == 0)
+      mBusy.store(false, ::std::memory_order_release);
+}
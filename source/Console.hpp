@@ -0,0 +1,139 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "LogQueue.hpp"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+
+///                                                                           
+///   Command console                                                         
+///                                                                           
+///   Turns submitted commands into scripts right away, which is expected to  
+/// be cheap - the real work of a script, parsing included, belongs in its    
+/// steps or in its Prepare. Scripts are run step by step by Execute, on the  
+/// thread that owns whatever they touch, within a time budget per call, so   
+/// that a long command is spread over many frames. Results are streamed back through a lock-free queue, as
+/// soon as they are produced. Running commands can be cancelled between      
+/// steps. Recent commands are kept in a bounded history, along with their    
+/// parse results, so re-running a command doesn't parse it again.            
+///                                                                           
+class Console {
+public:
+   /// A parsed command, executed as a sequence of steps                      
+   struct Script {
+      virtual ~Script() = default;
+
+      /// Called by Execute, before the first step of every run - anything    
+      /// that touches shared state belongs here, and not in the parser       
+      virtual void Prepare() {}
+      virtual uint32_t GetSteps() const noexcept = 0;
+      virtual void Run(uint32_t, Console&) const = 0;
+   };
+
+   /// Turns a command into a script, on the thread that submits it - may     
+   /// throw, and the message becomes the result                              
+   using Parser = ::std::function<::std::shared_ptr<Script>(::std::string_view)>;
+
+   /// Usage statistics                                                       
+   struct Stats {
+      // Commands that had to be parsed                                 
+      uint64_t mParsed {};
+      // Commands whose parse result was reused from the history        
+      uint64_t mReused {};
+      // Commands that were cancelled before they finished              
+      uint64_t mCancelled {};
+   };
+
+   static constexpr uint32_t HistorySize = 64;
+   static constexpr Kernels::RGB8 EchoColor  = Kernels::Pack(255, 140, 0);
+   static constexpr Kernels::RGB8 ErrorColor = Kernels::Pack(255, 64, 64);
+
+   Console(Parser, uint32_t fragments = 4096);
+   ~Console();
+
+   void Submit(::std::string_view);
+   void Cancel();
+   uint32_t Execute(::std::chrono::nanoseconds);
+   void Write(::std::string_view, Kernels::RGB8 = LogQueue::DefaultColor, uint8_t style = 0) noexcept;
+   bool GetHistory(uint32_t, ::std::string&) const;
+   auto GetStats() const -> Stats;
+
+   /// Get the statistics of the result queue, to find out if results were    
+   /// produced faster than drained, and got dropped                          
+   auto GetOutputStats() const noexcept -> LogQueue::Stats {
+      return mOutput.GetStats();
+   }
+
+   /// Check if a command is running, or waiting to be run                    
+   bool IsBusy() const noexcept {
+      return mBusy.load(::std::memory_order_acquire);
+   }
+
+   /// Move results to a log - only one thread may drain at a time            
+   ///   @param log - the log to move results to                              
+   ///   @param max - most fragments to move at once                          
+   ///   @return the number of moved fragments                                
+   uint32_t Drain(LogRing& log, uint32_t max) {
+      return mOutput.Drain(log, max);
+   }
+
+   /// Check if anything was written since the last check                     
+   bool TakeSignal() noexcept {
+      return mOutput.TakeSignal();
+   }
+
+   /// Check if the running command was cancelled - scripts that take a while 
+   /// can check this inside their steps, too                                 
+   bool IsCancelled() const noexcept {
+      return mCancels.load(::std::memory_order_acquire) != mRunning;
+   }
+
+private:
+   /// A command in the history                                               
+   struct Entry {
+      ::std::string mText;
+      ::std::shared_ptr<Script> mScript;
+   };
+
+   /// A parsed command, waiting for Execute                                  
+   struct Ready {
+      ::std::shared_ptr<Script> mScript;
+      // Value of the cancel counter when the command was submitted     
+      uint64_t mGeneration;
+   };
+
+   auto Parse(const ::std::string&) -> ::std::shared_ptr<Script>;
+   bool Next();
+   void Retire();
+
+   Parser mParser;
+   LogQueue mOutput;
+
+   mutable ::std::mutex mMutex;
+   ::std::deque<Ready> mReady;
+   // Most recent first                                                 
+   ::std::deque<Entry> mHistory;
+   Stats mStats;
+   // Commands parsed, but not yet finished                             
+   uint32_t mQueued = 0;
+
+   // Incremented by Cancel - a command runs only while this matches    
+   // the value it was picked up with                                   
+   ::std::atomic<uint64_t> mCancels {0};
+   ::std::atomic<bool> mBusy {false};
+
+   // The running command, owned by the thread that calls Execute       
+   ::std::shared_ptr<Script> mScript;
+   uint32_t mStep = 0;
+   uint64_t mRunning = 0;
+};
@@ -0,0 +1,256 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Encoder.hpp"
+#include <algorithm>
+#include <cstring>
+
+
+/// Append a decimal number to a string, without any allocations              
+///   @param out - the string to append to                                    
+///   @param n - the number                                                   
+void AppendNumber(::std::string& out, uint32_t n) {
+   char digits[10];
+   char* end = digits + sizeof(digits);
+   char* p = end;
+   do {
+      *--p = static_cast<char>('0' + n % 10);
+      n /= 10;
+   } while (n);
+   out.append(p, end);
+}
+
+/// Append the SGR parameters of a color, using the shortest form the color   
+/// allows - palette entries are a lot shorter than truecolors                
+///   @param out - the string to append to                                    
+///   @param c - the color                                                    
+///   @param fg - true for a foreground color, false for a background one     
+void AppendColor(::std::string& out, Kernels::RGB8 c, bool fg) {
+   switch (Kernels::PaletteOf(c)) {
+   case Kernels::Indexed16: {
+      const auto i = Kernels::Index(c);
+      AppendNumber(out, (i < 8 ? 30 + i : 90 + i - 8) + (fg ? 0 : 10));
+      return;
+   }
+   case Kernels::Indexed256:
+      out += fg ? "38;5;" : "48;5;";
+      AppendNumber(out, Kernels::Index(c));
+      return;
+   default:
+      break;
+   }
+
+   out += fg ? "38;2;" : "48;2;";
+   AppendNumber(out, Kernels::Red(c));
+   out += ';';
+   AppendNumber(out, Kernels::Green(c));
+   out += ';';
+   AppendNumber(out, Kernels::Blue(c));
+}
+
+/// Check if the encoder can produce a difference to the given cells, or a    
+/// full redraw is required instead                                           
+///   @param cells - the cells to encode next                                 
+///   @return true if Encode will produce a valid difference                  
+bool Encoder::CanDiff(const CellBuffer& cells) const noexcept {
+   return mSynced
+      and cells.mWidth == mPrevious.mWidth
+      and cells.mHeight == mPrevious.mHeight;
+}
+
+/// Tell the encoder that the terminal was fully redrawn with these cells,    
+/// by someone else - the terminal state is unknown afterwards                
+///   @param cells - what the terminal displays now                           
+void Encoder::Sync(const CellBuffer& cells) {
+   mPrevious.Resize(cells.mWidth, cells.mHeight);
+   ::std::copy(cells.mGlyphs.begin(), cells.mGlyphs.end(), mPrevious.mGlyphs.begin());
+   ::std::copy(cells.mFg.begin(), cells.mFg.end(), mPrevious.mFg.begin());
+   ::std::copy(cells.mBg.begin(), cells.mBg.end(), mPrevious.mBg.begin());
+   ::std::copy(cells.mStyles.begin(), cells.mStyles.end(), mPrevious.mStyles.begin());
+   mSynced = true;
+   ++mStats.mSyncs;
+}
+
+/// Forget what the terminal displays, so that the next frame can only be     
+/// presented with a full redraw                                              
+void Encoder::Invalidate() noexcept {
+   mSynced = false;
+}
+
+/// Encode the difference between the previously encoded frame and this one   
+/// The output saves the cursor and attributes, and restores them at the end, 
+/// so it can be interleaved with whatever else draws to the terminal         
+///   @attention CanDiff must be true                                         
+///   @param cells - the cells to encode                                      
+///   @param glyphs - the table the glyph identifiers refer to                
+///   @param width - width of the terminal, cells beyond it are clipped       
+///   @param height - height of the terminal, cells beyond it are clipped     
+///   @param out - [out] the escape sequences, empty if nothing changed       
+void Encoder::Encode(
+   const CellBuffer& cells, const GlyphTable& glyphs,
+   uint32_t width, uint32_t height, ::std::string& out
+) {
+   out.clear();
+   out += "\x1b" "7";
+   const auto start = out.size();
+   mCursorKnown = false;
+   mStyleKnown = false;
+   mStats.mCells = 0;
+
+   width = ::std::min(width, cells.mWidth);
+   height = ::std::min(height, cells.mHeight);
+   const auto same = [&](size_t i) noexcept {
+      return cells.mGlyphs[i] == mPrevious.mGlyphs[i]
+         and cells.mFg[i] == mPrevious.mFg[i]
+         and cells.mBg[i] == mPrevious.mBg[i]
+         and cells.mStyles[i] == mPrevious.mStyles[i];
+   };
+
+   for (uint32_t y = 0; y < height; ++y) {
+      const auto row = cells.RowOffset(y);
+
+      // Most rows of most frames don't change at all                   
+      if (0 == ::std::memcmp(cells.mBg.data() + row, mPrevious.mBg.data() + row, width * sizeof(Kernels::RGB8))
+      and 0 == ::std::memcmp(cells.mGlyphs.data() + row, mPrevious.mGlyphs.data() + row, width * sizeof(GlyphID))
+      and 0 == ::std::memcmp(cells.mFg.data() + row, mPrevious.mFg.data() + row, width * sizeof(Kernels::RGB8))
+      and 0 == ::std::memcmp(cells.mStyles.data() + row, mPrevious.mStyles.data() + row, width))
+         continue;
+
+      uint32_t x = 0;
+      while (x < width) {
+         if (same(row + x)) {
+            ++x;
+            continue;
+         }
+
+         // A changed span begins - a wide grapheme has to be rewritten 
+         // from its first cell, if its continuation changed            
+         auto first = x;
+         if (first > 0 and cells.mGlyphs[row + first] == GlyphTable::Empty)
+            --first;
+
+         // Extend the span over short unchanged gaps                   
+         auto last = x;
+         uint32_t gap = 0;
+         for (auto i = x + 1; i < width; ++i) {
+            if (same(row + i)) {
+               if (++gap > MaxGap)
+                  break;
+            }
+            else {
+               last = i;
+               gap = 0;
+            }
+         }
+
+         MoveTo(first, y, out);
+         for (auto i = first; i <= last; ++i)
+            WriteCell(cells, row + i, glyphs, out);
+         x = last + 1;
+      }
+
+      // The row is now up to date on the terminal                      
+      ::std::copy_n(cells.mGlyphs.data() + row, width, mPrevious.mGlyphs.data() + row);
+      ::std::copy_n(cells.mFg.data() + row, width, mPrevious.mFg.data() + row);
+      ::std::copy_n(cells.mBg.data() + row, width, mPrevious.mBg.data() + row);
+      ::std::copy_n(cells.mStyles.data() + row, width, mPrevious.mStyles.data() + row);
+   }
+
+   if (out.size() == start)
+      out.clear();
+   else
+      out += "\x1b" "8";
+
+   ++mStats.mFrames;
+   mStats.mBytes = out.size();
+   mStats.mTotalBytes += out.size();
+}
+
+/// Move the cursor, using the shortest sequence that gets it there           
+///   @param x, y - the cell to move to                                       
+///   @param out - the string to append to                                    
+void Encoder::MoveTo(uint32_t x, uint32_t y, ::std::string& out) {
+   if (mCursorKnown and mCursorY == y) {
+      if (mCursorX == x)
+         return;
+
+      // Column absolute is shorter than a full position                
+      out += "\x1b[";
+      AppendNumber(out, x + 1);
+      out += 'G';
+   }
+   else {
+      out += "\x1b[";
+      AppendNumber(out, y + 1);
+      out += ';';
+      AppendNumber(out, x + 1);
+      out += 'H';
+   }
+
+   mCursorX = x;
+   mCursorY = y;
+   mCursorKnown = true;
+}
+
+/// Write a cell at the cursor, setting only attributes that changed          
+///   @param cells - the cells                                                
+///   @param i - index of the cell to write                                   
+///   @param glyphs - the table the glyph identifiers refer to                
+///   @param out - the string to append to                                    
+void Encoder::WriteCell(
+   const CellBuffer& cells, size_t i, const GlyphTable& glyphs, ::std::string& out
+) {
+   const auto glyph = cells.mGlyphs[i];
+   const auto fg = cells.mFg[i];
+   const auto bg = cells.mBg[i];
+   const auto style = cells.mStyles[i];
+
+   if (glyph == GlyphTable::Empty) {
+      // Continuation of a wide grapheme - the terminal already moved   
+      // the cursor over it                                             
+      ++mCursorX;
+      return;
+   }
+
+   if (not mStyleKnown or style != mStyle) {
+      // Emphasis can only be removed by a reset, so set all at once    
+      out += "\x1b[0";
+      if (style & CellBold)             out += ";1";
+      if (style & CellDim)              out += ";2";
+      if (style & CellItalic)           out += ";3";
+      if (style & CellUnderlined)       out += ";4";
+      if (style & CellBlink)            out += ";5";
+      if (style & CellInverted)         out += ";7";
+      if (style & CellStrikethrough)    out += ";9";
+      if (style & CellUnderlinedDouble) out += ";21";
+      out += ';';
+      AppendColor(out, fg, true);
+      out += ';';
+      AppendColor(out, bg, false);
+      out += 'm';
+      mStyle = style;
+      mFg = fg;
+      mBg = bg;
+      mStyleKnown = true;
+   }
+   else if (fg != mFg or bg != mBg) {
+      out += "\x1b[";
+      if (fg != mFg)
+         AppendColor(out, fg, true);
+      if (fg != mFg and bg != mBg)
+         out += ';';
+      if (bg != mBg)
+         AppendColor(out, bg, false);
+      out += 'm';
+      mFg = fg;
+      mBg = bg;
+   }
+
+   out += glyphs.Get(glyph);
+   ++mCursorX;
+   ++mStats.mCells;
+}
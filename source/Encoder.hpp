@@ -0,0 +1,70 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Cells.hpp"
+
+
+///                                                                           
+///   Terminal diff encoder                                                   
+///                                                                           
+///   Produces the escape sequences that turn the previously encoded frame    
+/// into the current one. Only changed spans are written, using absolute      
+/// cursor jumps between them, and SGR attributes are emitted only when they  
+/// differ from the ones already set, so runs of identically styled cells     
+/// share a single SGR sequence. Short unchanged gaps inside a span are       
+/// rewritten, whenever that is cheaper than jumping over them.               
+///                                                                           
+class Encoder {
+public:
+   /// Output statistics                                                      
+   struct Stats {
+      // Number of encoded frames                                       
+      size_t mFrames {};
+      // Bytes produced for the last frame                              
+      size_t mBytes {};
+      // Bytes produced for all frames                                  
+      size_t mTotalBytes {};
+      // Cells written for the last frame                               
+      size_t mCells {};
+      // Number of times the encoder was synchronized to a full redraw  
+      size_t mSyncs {};
+   };
+
+   bool CanDiff(const CellBuffer&) const noexcept;
+   void Sync(const CellBuffer&);
+   void Invalidate() noexcept;
+   void Encode(const CellBuffer&, const GlyphTable&, uint32_t, uint32_t, ::std::string&);
+
+   /// Get the output statistics                                              
+   const Stats& GetStats() const noexcept {
+      return mStats;
+   }
+
+private:
+   void MoveTo(uint32_t, uint32_t, ::std::string&);
+   void WriteCell(const CellBuffer&, size_t, const GlyphTable&, ::std::string&);
+
+   // Longest run of unchanged cells that is rewritten instead of jumped
+   // over - a jump is at least five bytes                              
+   static constexpr uint32_t MaxGap = 4;
+
+   // What the terminal displays, as far as the encoder knows           
+   CellBuffer mPrevious;
+   bool mSynced = false;
+
+   // Terminal state while encoding                                     
+   uint32_t mCursorX {};
+   uint32_t mCursorY {};
+   bool mCursorKnown = false;
+   Kernels::RGB8 mFg {};
+   Kernels::RGB8 mBg {};
+   uint8_t mStyle {};
+   bool mStyleKnown = false;
+
+   Stats mStats;
+};
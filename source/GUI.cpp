@@ -13,7 +13,15 @@
 LANGULUS_DEFINE_MODULE(
    GUI, 9, "FTXUI",
    "GUI generator and simulator, using FTXUI as backend", "",
-   GUI, GUISystem, GUIItem, GUIEditor
+   GUI, GUISystem, GUIItem, GUIEditor,
+   Traits::Threaded, Traits::Colors, Traits::Dither,
+   Traits::Headless, Traits::KeepAlive, Traits::HalfBlocks, Traits::Editor,
+   Traits::ConvertTime, Traits::LayoutTime, Traits::WriteTime,
+   Traits::CellsChanged, Traits::BytesEmitted, Traits::DroppedFrames,
+   Traits::InputEvents, Traits::Display, Traits::Search,
+   Traits::CellFormat, Traits::CellGlyphs, Traits::CellForeground,
+   Traits::CellBackground, Traits::CellStyles,
+   Traits::Widget, Traits::Caption, Traits::Progress
 )
 
 using namespace ftxui;
@@ -7,6 +7,7 @@
 ///                                                                           
 #pragma once
 #include "GUISystem.hpp"
+#include "WorkPool.hpp"
 #include <Langulus/Verbs/Create.hpp>
 #include <ftxui/component/component.hpp>
 
@@ -25,6 +26,8 @@ private:
    // List of created GUI systems                                       
    // Each system will appear as a tab on the top of the window         
    TFactory<GUISystem> mSystems;
+   // Threads shared by all systems, for converting large images        
+   WorkPool mPool;
 
 public:
    GUI(Runtime*, const Many&);
@@ -32,5 +35,10 @@ public:
    bool Update(Time);
    void Create(Verb&);
    void Teardown();
+
+   /// Get the thread pool, shared by all GUI systems                         
+   WorkPool& GetPool() noexcept {
+      return mPool;
+   }
 };
 
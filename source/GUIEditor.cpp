@@ -7,76 +7,49 @@
 ///                                                                           
 #include "GUIEditor.hpp"
 #include "GUI.hpp"
+#include <ftxui/dom/node.hpp>
+#include <cstdio>
+#include <stdexcept>
 
 using namespace ftxui;
 
 
-// Take a list of component, display them vertically, one column shifted to the
-// right.
-Component RepresentInner(std::vector<Component> children) {
-   Component vlist = Container::Vertical(std::move(children));
-   return Renderer(vlist, [vlist] {
-      return hbox({
-         text(" "),
-         vlist->Render(),
-      });
-   });
-}
-
-/// Represent a Trait as GUI                                                  
-///   @param trait - the trait to represent                                   
-///   @return the FTXUI representation                                        
-Component Represent(const Trait&) {
-   //TODO
-   return std::make_shared<ComponentBase>();
+/// Queue text logged from any thread                                         
+///   @param text - the text                                                  
+void LogSink::Write(const TextView& text) const noexcept {
+   mQueue.Push(LogQueue::Text, ::std::string_view {text.data(), text.size()});
 }
 
-/// Represent a Unit as GUI                                                   
-///   @param unit - the unit to represent                                     
-///   @return the FTXUI representation                                        
-Component Represent(const A::Unit&) {
-   //TODO
-   return std::make_shared<ComponentBase>();
-}
-
-/// Represent a Thing as GUI                                                  
-///   @param thing - the thing to represent                                   
-///   @return the FTXUI representation                                        
-Component Represent(const Thing& thing) {
-   std::vector<Component> properties;
-
-   // Represent traits                                                  
-   std::vector<Component> traits;
-   for (auto traitlist : thing.GetTraits()) {
-      for(auto& trait : traitlist.GetValue())
-         traits.push_back(Represent(trait));
+/// Queue a style change, applied to the line being logged by this thread     
+///   @param style - the style                                                
+void LogSink::Write(const Logger::Style& style) const noexcept {
+   auto color = LogQueue::DefaultColor;
+   if (style.has_foreground()) {
+      const auto fg = style.get_foreground();
+      if (fg.is_rgb) {
+         const auto rgb = fg.value.rgb_color;
+         color = Kernels::Pack((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+      }
+      else {
+         // Terminal colors are 30-37, and the bright ones 90-97        
+         const uint32_t term = fg.value.term_color;
+         color = Kernels::Indexed16 | (term >= 90 ? term - 90 + 8 : term - 30);
+      }
    }
-   if (not traits.empty())
-      properties.push_back(Collapsible("Traits", RepresentInner(traits)));
-
-   // Represent units                                                   
-   std::vector<Component> units;
-   for (auto& unit : thing.GetUnits())
-      units.push_back(Represent(*unit));
-   if (not units.empty())
-      properties.push_back(Collapsible("Units", RepresentInner(units)));
 
-   // Represent child-things                                            
-   std::vector<Component> children;
-   for (auto& child : thing.GetChildren())
-      children.push_back(Represent(*child));
-   if (not children.empty())
-      properties.push_back(Collapsible("Children", RepresentInner(children)));
+   const uint8_t bits = style.has_emphasis()
+      ? ToCellStyle(style.get_emphasis()) : uint8_t {};
+   mQueue.Push(LogQueue::Style, {}, color, bits);
+}
 
-   // Combine all thing's properties                                    
-   auto objectGroup = Collapsible("Thing", RepresentInner(properties));
+/// Queue the end of the line being logged by this thread                     
+void LogSink::NewLine() const noexcept {
+   mQueue.Push(LogQueue::NewLine);
+}
 
-   return Renderer(objectGroup, [objectGroup] {
-      return hbox({
-          text(" "),
-          objectGroup->Render(),
-      });
-   });
+/// Queue clearing the log                                                    
+void LogSink::Clear() const noexcept {
+   mQueue.Push(LogQueue::Clear);
 }
 
 
@@ -89,27 +62,36 @@ GUIEditor::GUIEditor(GUISystem* producer, const Many& descriptor)
    VERBOSE_GUI("Initializing...");
    
    // Create the tab selector                                           
-   mTabNames = {"Log", "Flow"};
+   mTabNames = {"Log", "Flow", "Stats"};
    mTabSelector = Toggle(&mTabNames, &mSelectedTab);
 
-   // The log tab                                                       
-   mLogTab = Container::Vertical({});
-   auto logTabRenderer = Renderer(mLogTab, [&] {
-      return vbox(mLog) | vscroll_indicator | frame | flex;
+   // The log tab - only the visible lines are ever built               
+   mLogTab = Renderer([this](bool) {
+      return RenderLog();
+   }) | CatchEvent([this](Event event) {
+      return ScrollLog(event);
    });
+   auto logTabRenderer = mLogTab;
 
-   // The flow tab                                                      
-   mFlowContents = Container::Vertical({});
-   mFlowCommand = Input(&mFlowCommandInput, " -input here- ");
+   // The flow tab - commands run on the console's own thread, and      
+   // their results are streamed into the contents                      
+   mFlowContents = Renderer([this](bool) {
+      return RenderFlow();
+   });
+   mFlowCommand = Input(&mFlowCommandInput, " -input here- ")
+      | CatchEvent([this](Event event) {
+         return FlowInput(event);
+      });
    mFlowTab = Container::Vertical({
       mFlowContents,
       mFlowCommand
+   }) | CatchEvent([this](Event event) {
+      return ScrollLines(event, mFlowLog, mFlowScroll, mFlowBox, false);
    });
 
    auto flowTabRenderer = Renderer(mFlowTab, [&] {
       return vbox({
          mFlowContents->Render(),
-         filler(),
          separatorCharacter(" ") | color(Color::DarkOrange) | underlined,
          hbox(
             text(">") | color(Color::DarkOrange) | bold,
@@ -119,10 +101,16 @@ GUIEditor::GUIEditor(GUISystem* producer, const Many& descriptor)
       });
    });
 
+   // The statistics tab - recent frames of the GUI system              
+   auto statsTabRenderer = Renderer([this](bool) {
+      return RenderStats();
+   });
+
    // The combined tabs                                                 
    mTabContents = Container::Tab({
       logTabRenderer,
-      flowTabRenderer
+      flowTabRenderer,
+      statsTabRenderer
    }, &mSelectedTab);
 
    // The left panel, composed of mainly tabs                           
@@ -138,13 +126,20 @@ GUIEditor::GUIEditor(GUISystem* producer, const Many& descriptor)
       });
    });
 
-   // The right panel, composed of the hierarchy tree, and selection    
-   mTree = Container::Vertical({});
-   for (auto& thing : GetOwners())
-      mTree->Add(Represent(*thing));
+   // The right panel, composed of the hierarchy tree, and selection -  
+   // the tree is populated as it's expanded, and only the visible rows 
+   // are ever built. Typing in the filter narrows the tree down to     
+   // matches from the search index                                     
+   mFilter = Input(&mFilterInput, " filter ");
+   mTree = Renderer([this](bool focused) {
+      return RenderTree(focused);
+   }) | CatchEvent([this](Event event) {
+      return NavigateTree(event);
+   });
 
    mSelection = Container::Vertical({});
    mRightPanel = Container::Vertical({
+      mFilter,
       mTree,
       mSelection
    });
@@ -152,9 +147,9 @@ GUIEditor::GUIEditor(GUISystem* producer, const Many& descriptor)
    auto rightRenderer = Renderer(mRightPanel, [this] {
       return vbox({
          text("Hierarchy:"),
+         hbox(text("Find: "), mFilter->Render()),
          separator(),
-         mTree->Render(),
-         filler(),
+         mTree->Render() | yflex_grow,
          separator(),
          mSelection->Render()
       });
@@ -163,12 +158,957 @@ GUIEditor::GUIEditor(GUISystem* producer, const Many& descriptor)
    // Combine both panels in a resizable split                          
    mMain = ResizableSplitRight(rightRenderer, leftRenderer, &mSplit);
 
+   // Move logged lines to the log once per frame, on the thread that   
+   // renders - the only one allowed to drain the sink                  
+   mRenderer = Renderer(mMain, [this] {
+      DrainLog();
+      DrainFlow();
+      return mMain->Render();
+   });
+
+   // Duplicate all logging into the log tab, from now on               
+   Logger::AttachDuplicator(&mLogSink);
+
    Couple(descriptor);
    VERBOSE_GUI("Initialized");
 }
 
+/// GUI editor destruction                                                    
+GUIEditor::~GUIEditor() {
+   Logger::DettachDuplicator(&mLogSink);
+}
+
+/// Run flow commands, reconcile the mirror of the hierarchy, and check for   
+/// newly logged lines, to have them shown                                    
+/// Commands run here, on the main thread, because they touch the hierarchy - 
+/// only for a while each update, so a long command doesn't stall frames.     
+/// Draining is left to the renderer, only the signal is taken here           
+void GUIEditor::Update(Time) {
+   // Commands might have changed the owners                            
+   if (mConsole.Execute(FlowBudget))
+      mHierarchyStale.store(true, ::std::memory_order_release);
+   const bool reconciled = ReconcileHierarchy();
+
+   // Both signals have to be taken, so don't short-circuit             
+   const bool logged = mLogSink.mQueue.TakeSignal();
+   const bool results = mConsole.TakeSignal();
+   if (reconciled or logged or results)
+      GetProducer()->Invalidate();
+}
+
+/// Move a batch of logged lines from the sink to the log                     
+/// Batches are capped, so that a flood of logging can't stall a frame - the  
+/// rest stays queued for the next one                                        
+void GUIEditor::DrainLog() {
+   const auto pushed = mLog.GetPushed();
+   mLogSink.mQueue.Drain(mLog, LogBatch);
+
+   // Keep showing the same lines, unless following the log             
+   if (mLogScroll)
+      mLogScroll += static_cast<int>(mLog.GetPushed() - pushed);
+}
+
+/// Get the statistics of the log sink, to find out if producers outrun the   
+/// editor, and lines get dropped                                             
+///   @return the statistics                                                  
+auto GUIEditor::GetLogStats() const noexcept -> LogQueue::Stats {
+   return mLogSink.mQueue.GetStats();
+}
+
+/// Get the component of the whole editor, for mounting it in a tree          
+///   @return the component                                                   
+auto GUIEditor::GetComponent() const noexcept -> const Component& {
+   return mRenderer;
+}
+
+/// Add a line to the log tab                                                 
+///   @param text - the line                                                  
+///   @param color - color of the text                                        
+///   @param style - style bits of the text                                   
+void GUIEditor::Log(::std::string_view text, Kernels::RGB8 color, uint8_t style) {
+   mLog.Push(text, color, style);
+
+   // Keep showing the same lines, unless following the log             
+   if (mLogScroll)
+      ++mLogScroll;
+}
+
+/// Get the number of bytes in a UTF-8 sequence, from its first byte          
+///   @param lead - the first byte                                            
+///   @return the number of bytes, one for invalid lead bytes                 
+size_t SequenceLength(char lead) noexcept {
+   const auto byte = static_cast<uint8_t>(lead);
+   if (byte >= 0xF0) return 4;
+   if (byte >= 0xE0) return 3;
+   if (byte >= 0xC0) return 2;
+   return 1;
+}
+
+///                                                                           
+///   Log line node                                                           
+///                                                                           
+///   Draws a line straight from the log's text, without copying it. A node   
+/// is kept for each visible row, and only pointed to another line on each    
+/// render, so showing a log allocates nothing once the area stops changing.  
+/// Each code point takes a single column, which holds for the text that      
+/// usually gets logged.                                                      
+///                                                                           
+class LineNode : public Node {
+public:
+   LogRing::Line mLine {};
+
+   void ComputeRequirement() override {
+      int columns = 0;
+      for (size_t i = 0; i < mLine.mText.size(); i += SequenceLength(mLine.mText[i]))
+         ++columns;
+      requirement_.min_x = columns;
+      requirement_.min_y = 1;
+   }
+
+   void Render(Screen& screen) override {
+      const int y = box_.y_min;
+      if (y > box_.y_max)
+         return;
+
+      const auto fg = ToColor(mLine.mColor);
+      const auto style = mLine.mStyle;
+      auto text = mLine.mText;
+      for (int x = box_.x_min; x <= box_.x_max and not text.empty(); ++x) {
+         const auto length = ::std::min(SequenceLength(text.front()), text.size());
+         auto& pixel = screen.PixelAt(x, y);
+
+         // Assigning reuses the pixel's string capacity                
+         pixel.grapheme.assign(text.data(), length);
+         pixel.style.foreground_color = fg;
+         pixel.style.bold = style & CellBold;
+         pixel.style.dim = style & CellDim;
+         pixel.style.italic = style & CellItalic;
+         pixel.style.underlined = style & CellUnderlined;
+         pixel.style.inverted = style & CellInverted;
+         text.remove_prefix(length);
+      }
+   }
+};
+
+/// Build elements for the lines of a log that fit in an area                 
+/// The cost depends only on the height of the area, never on the number of   
+/// lines in the log. Elements are built only when the height changes, and    
+/// otherwise only pointed to other lines                                     
+///   @param log - the log                                                    
+///   @param scroll - [in/out] lines scrolled up from the newest one          
+///   @param box - the area the lines were rendered in last time              
+///   @param cache - [in/out] the elements of the rows                        
+///   @return the lines element                                               
+const Element& RenderLines(const LogRing& log, int& scroll, Box& box, GUIEditor::LineCache& cache) {
+   const int rows = ::std::max(box.y_max - box.y_min + 1, 1);
+   const int count = static_cast<int>(log.GetCount());
+   scroll = ::std::clamp(scroll, 0, ::std::max(count - rows, 0));
+
+   if (cache.mRows.size() != static_cast<size_t>(rows)) {
+      cache.mRows.clear();
+      Elements lines;
+      for (int row = 0; row < rows; ++row)
+         lines.push_back(cache.mRows.emplace_back(::std::make_shared<LineNode>()));
+      cache.mElement = vbox(::std::move(lines)) | yflex_grow | reflect(box);
+   }
+
+   const int end = count - scroll;
+   const int begin = ::std::max(end - rows, 0);
+   for (int row = 0; row < rows; ++row) {
+      const int i = begin + row;
+      cache.mRows[static_cast<size_t>(row)]->mLine = i < end
+         ? log.Get(static_cast<uint32_t>(i)) : LogRing::Line {};
+   }
+   return cache.mElement;
+}
+
+/// Scroll the lines of a log                                                 
+///   @param event - the event to react to                                    
+///   @param log - the log                                                    
+///   @param scroll - [in/out] lines scrolled up from the newest one          
+///   @param box - the area the lines were rendered in last time              
+///   @param arrows - whether arrow keys scroll, too                          
+///   @return true if the event scrolled the lines                            
+bool ScrollLines(const Event& event, const LogRing& log, int& scroll, const Box& box, bool arrows) {
+   const int page = ::std::max(box.y_max - box.y_min, 1);
+   if (arrows and event == Event::ArrowUp)
+      scroll += 1;
+   else if (arrows and event == Event::ArrowDown)
+      scroll -= 1;
+   else if (event == Event::PageUp)
+      scroll += page;
+   else if (event == Event::PageDown)
+      scroll -= page;
+   else if (arrows and event == Event::Home)
+      scroll = static_cast<int>(log.GetCount());
+   else if (arrows and event == Event::End)
+      scroll = 0;
+   else if (event.is_mouse() and event.mouse().button == Mouse::WheelUp)
+      scroll += 3;
+   else if (event.is_mouse() and event.mouse().button == Mouse::WheelDown)
+      scroll -= 3;
+   else
+      return false;
+
+   // Clamped when rendering, but never scroll below the newest line    
+   scroll = ::std::max(scroll, 0);
+   return true;
+}
+
+/// Build elements for the log tab                                            
+///   @return the log element                                                 
+Element GUIEditor::RenderLog() {
+   const auto& lines = RenderLines(mLog, mLogScroll, mLogBox, mLogLines);
+
+   // The tab is composed again only when its status changes            
+   const auto dropped = mLogSink.mQueue.GetStats().mDropped;
+   if (mLogElement and mLogShown == lines.get()
+   and mLogDropped == dropped and mLogScrolled == mLogScroll)
+      return mLogElement;
+
+   mLogShown = lines.get();
+   mLogDropped = dropped;
+   mLogScrolled = mLogScroll;
+
+   // Position indicator, when not following the log, and a warning,    
+   // when producers outran the editor                                  
+   Elements status {text("")};
+   if (dropped) {
+      status.push_back(text(" " + ::std::to_string(dropped) + " log fragments dropped ")
+         | color(Color::Red));
+   }
+   status.push_back(filler());
+   if (mLogScroll)
+      status.push_back(text(" ↓ " + ::std::to_string(mLogScroll) + " newer lines ") | inverted);
+
+   mLogElement = vbox({
+      lines,
+      hbox(::std::move(status))
+   }) | flex;
+   return mLogElement;
+}
+
+/// Format a statistic for the stats tab                                      
+///   @param value - the value                                                
+///   @param time - whether the value is a duration in nanoseconds            
+///   @return the formatted value                                             
+::std::string FormatStat(uint64_t value, bool time) {
+   if (not time)
+      return ::std::to_string(value);
+
+   char buffer[32];
+   if (value < 1000)
+      ::std::snprintf(buffer, sizeof(buffer), "%lluns", static_cast<unsigned long long>(value));
+   else if (value < 1000000)
+      ::std::snprintf(buffer, sizeof(buffer), "%.1fus", value / 1e3);
+   else
+      ::std::snprintf(buffer, sizeof(buffer), "%.2fms", value / 1e6);
+   return buffer;
+}
+
+/// Build a row of the stats tab, summarizing a histogram                     
+///   @param name - name of the statistic                                     
+///   @param histogram - the histogram to summarize                           
+///   @param time - whether the samples are durations in nanoseconds          
+///   @return the row                                                         
+Elements StatsRow(const char* name, const Histogram& histogram, bool time) {
+   const auto snapshot = histogram.GetSnapshot();
+   return {
+      text(name) | color(Color::DarkOrange),
+      text(::std::to_string(snapshot.mCount)) | align_right,
+      text(FormatStat(snapshot.Percentile(50), time)) | align_right,
+      text(FormatStat(snapshot.Percentile(99), time)) | align_right,
+      text(FormatStat(snapshot.mMax, time)) | align_right
+   };
+}
+
+/// Build elements for the stats tab                                          
+///   @return the stats element                                               
+Element GUIEditor::RenderStats() {
+   const auto system = GetProducer();
+   const auto& stats = system->GetStats();
+   const auto input = system->GetInputStats();
+   const auto output = system->GetOutputStats();
+
+   auto header = [](const char* label) {
+      return text(label) | bold | align_right;
+   };
+
+   return vbox({
+      gridbox({
+         {text(""), header("  samples"), header("  p50"), header("  p99"), header("  max")},
+         StatsRow("convert", stats.mConvert, true),
+         StatsRow("layout",  stats.mLayout,  true),
+         StatsRow("write",   stats.mWrite,   true),
+         StatsRow("cells",   stats.mCells,   false),
+         StatsRow("bytes",   stats.mBytes,   false),
+         StatsRow("input",   stats.mInput,   false)
+      }),
+      separatorCharacter(" "),
+      text("dropped frames: " + ::std::to_string(system->GetDroppedFrames())),
+      text("idle updates: " + ::std::to_string(system->GetIdleUpdates())),
+      text("coalesced input: " + ::std::to_string(input.mCoalesced)
+         + " of " + ::std::to_string(input.mPushed)),
+      text("bytes written: " + ::std::to_string(output.mTotalBytes)
+         + " in " + ::std::to_string(output.mFrames) + " frames")
+   }) | flex;
+}
+
+/// Scroll the log tab                                                        
+///   @param event - the event to react to                                    
+///   @return true if the event scrolled the log                              
+bool GUIEditor::ScrollLog(const Event& event) {
+   return ScrollLines(event, mLog, mLogScroll, mLogBox, true);
+}
+
+/// A Flow command, run against the editor's owner, one top-level element     
+/// of the parsed code per step                                               
+/// Parsing Flow resolves tokens in the reflection database, and the owner    
+/// belongs to the hierarchy, so both are left to Prepare, which runs on the  
+/// main thread - the parse result is kept for when the command is rerun      
+struct FlowScript final : Console::Script {
+   ::std::string mCode;
+   const GUIEditor* mEditor;
+   Many mParsed;
+   bool mIsParsed = false;
+   Thing* mContext {};
+
+   FlowScript(::std::string_view code, const GUIEditor* editor)
+      : mCode {code}
+      , mEditor {editor} {}
+
+   void Prepare() override {
+      mContext = nullptr;
+      for (auto& owner : mEditor->GetOwners()) {
+         mContext = &*owner;
+         break;
+      }
+
+      if (not mContext)
+         throw ::std::runtime_error("The editor has no owner to run commands in");
+
+      if (not mIsParsed) {
+         mParsed = Code {mCode}.Parse();
+         mIsParsed = true;
+      }
+   }
+
+   uint32_t GetSteps() const noexcept override {
+      return static_cast<uint32_t>(mParsed.GetCount());
+   }
+
+   void Run(uint32_t step, Console& console) const override {
+      const auto result = mContext->Run(mParsed.GetElement(step));
+      if (result)
+         console.Write(Token {static_cast<Text>(result)});
+   }
+};
+
+/// Wrap a Flow command, as soon as it's submitted                            
+/// Nothing shared is touched here - the command is parsed by Prepare         
+///   @param code - the command                                               
+///   @return the command                                                     
+auto GUIEditor::ParseFlow(::std::string_view code) -> ::std::shared_ptr<Console::Script> {
+   return ::std::make_shared<FlowScript>(code, this);
+}
+
+/// Move a batch of results from the console to the flow tab                  
+void GUIEditor::DrainFlow() {
+   const auto pushed = mFlowLog.GetPushed();
+   mConsole.Drain(mFlowLog, LogBatch);
+
+   // Keep showing the same lines, unless following the results         
+   if (mFlowScroll)
+      mFlowScroll += static_cast<int>(mFlowLog.GetPushed() - pushed);
+}
+
+/// Build elements for the flow tab's results                                 
+///   @return the results element                                             
+Element GUIEditor::RenderFlow() {
+   const auto& lines = RenderLines(mFlowLog, mFlowScroll, mFlowBox, mFlowLines);
+   if (not mConsole.IsBusy())
+      return lines;
+
+   return vbox({
+      lines,
+      text(" running... Escape to cancel ") | dim | align_right
+   });
+}
+
+/// Submit, cancel, and recall commands in the flow tab                       
+///   @param event - the event to react to                                    
+///   @return true if the event was handled                                   
+bool GUIEditor::FlowInput(const Event& event) {
+   if (event == Event::Return) {
+      if (mFlowCommandInput.empty())
+         return true;
+      mConsole.Submit(mFlowCommandInput);
+      mFlowCommandInput.clear();
+      mFlowHistory = -1;
+      mFlowScroll = 0;
+      return true;
+   }
+
+   if (event == Event::Escape) {
+      mConsole.Cancel();
+      return true;
+   }
+
+   if (event == Event::ArrowUp or event == Event::ArrowDown) {
+      // Browse the history, most recent first                          
+      const int age = mFlowHistory + (event == Event::ArrowUp ? 1 : -1);
+      if (age < 0) {
+         mFlowHistory = -1;
+         mFlowCommandInput.clear();
+      }
+      else if (mConsole.GetHistory(static_cast<uint32_t>(age), mFlowCommandInput))
+         mFlowHistory = age;
+      return true;
+   }
+   return false;
+}
+
+/// Get the label of a Thing                                                  
+///   @param thing - the thing                                                
+///   @return its name, or a generic label if unnamed                         
+::std::string Label(const Thing& thing) {
+   const Text name = thing.GetName();
+   return name.IsEmpty() ? "Thing" : ::std::string {Token {name}};
+}
+
+/// Get the label of a unit                                                   
+///   @param unit - the unit                                                  
+///   @return its type token                                                  
+::std::string Label(const A::Unit& unit) {
+   return ::std::string {unit.GetType()->mToken};
+}
+
+/// Get the label of a trait                                                  
+///   @param trait - the trait                                                
+///   @return its trait token, or a generic label if untyped                  
+::std::string Label(const Trait& trait) {
+   const auto meta = trait.GetTrait();
+   return meta ? ::std::string {meta->mToken} : "Trait";
+}
+
+/// Collect the units and traits of a Thing                                   
+///   @param thing - the thing                                                
+///   @param members - [out] its units, followed by its traits                
+void CollectMembers(const Thing& thing, ::std::vector<GUIEditor::MirrorMember>& members) {
+   members.clear();
+   for (auto& unit : thing.GetUnits())
+      members.push_back({&*unit, Label(*unit), GUIEditor::NodeUnit});
+
+   for (auto traitlist : thing.GetTraits()) {
+      for (auto& trait : traitlist.GetValue())
+         members.push_back({&trait, Label(trait), GUIEditor::NodeTrait});
+   }
+}
+
+/// Mirror and index a Thing that is new to the editor, with all its children 
+///   @param thing - the thing                                                
+///   @param parent - the thing's parent, or nullptr for owners               
+void GUIEditor::MirrorThing(const Thing& thing, const void* parent) {
+   // Elements of the map stay where they are, while others are added   
+   auto& mirror = mMirror[&thing];
+   mirror.mParent = parent;
+   mirror.mLabel = Label(thing);
+   mIndex.Touch(&thing, parent, mirror.mLabel, NodeThing);
+
+   CollectMembers(thing, mirror.mMembers);
+   for (auto& member : mirror.mMembers)
+      mIndex.Touch(member.mKey, &thing, member.mLabel, member.mKind);
+
+   mirror.mChildren.clear();
+   for (auto& child : thing.GetChildren()) {
+      mirror.mChildren.push_back(&*child);
+      MirrorThing(*child, &thing);
+   }
+}
+
+/// Forget a Thing that left the hierarchy, with all its children             
+/// Only the mirror is consulted, because the thing might be gone already     
+///   @param key - the thing                                                  
+void GUIEditor::ForgetThing(const void* key) {
+   const auto found = mMirror.find(key);
+   if (found == mMirror.end())
+      return;
+
+   for (auto child : found->second.mChildren)
+      ForgetThing(child);
+   for (auto& member : found->second.mMembers)
+      mIndex.Remove(member.mKey);
+   mIndex.Remove(key);
+   mMirror.erase(found);
+}
+
+/// Apply the changes of a mirrored Thing to the mirror and the index         
+/// Only the thing's own name, units, traits, and list of children are        
+/// compared - children that joined are mirrored whole, those that left are   
+/// forgotten whole, and the rest are left for the sweep to visit             
+///   @param thing - the thing to reconcile                                   
+///   @return true if anything changed                                        
+bool GUIEditor::ReconcileThing(const Thing& thing) {
+   auto& mirror = mMirror[&thing];
+   bool changed = false;
+   auto label = Label(thing);
+   if (mirror.mLabel != label) {
+      mirror.mLabel = ::std::move(label);
+      mIndex.Touch(&thing, mirror.mParent, mirror.mLabel, NodeThing);
+      changed = true;
+   }
+
+   ::std::vector<MirrorMember> members;
+   CollectMembers(thing, members);
+   const bool same = ::std::equal(
+      members.begin(), members.end(),
+      mirror.mMembers.begin(), mirror.mMembers.end(),
+      [](const MirrorMember& a, const MirrorMember& b) {
+         return a.mKey == b.mKey and a.mLabel == b.mLabel;
+      });
+
+   if (not same) {
+      for (auto& member : mirror.mMembers) {
+         const auto kept = ::std::find_if(members.begin(), members.end(),
+            [&](const MirrorMember& m) { return m.mKey == member.mKey; });
+         if (kept == members.end())
+            mIndex.Remove(member.mKey);
+      }
+      // Touching an unchanged member only looks it up                  
+      for (auto& member : members)
+         mIndex.Touch(member.mKey, &thing, member.mLabel, member.mKind);
+      mirror.mMembers = ::std::move(members);
+      changed = true;
+   }
+
+   ::std::vector<const void*> children;
+   for (auto& child : thing.GetChildren())
+      children.push_back(&*child);
+   if (children == mirror.mChildren)
+      return changed;
+
+   // Forget the children that left first, in case any of theirs moved  
+   // here. Children that moved elsewhere and were mirrored there       
+   // already are left alone                                            
+   const auto previous = ::std::move(mirror.mChildren);
+   for (auto child : previous) {
+      if (::std::find(children.begin(), children.end(), child) != children.end())
+         continue;
+
+      const auto found = mMirror.find(child);
+      if (found != mMirror.end() and found->second.mParent == &thing)
+         ForgetThing(child);
+   }
+
+   for (auto& child : thing.GetChildren()) {
+      if (::std::find(previous.begin(), previous.end(), &*child) == previous.end())
+         MirrorThing(*child, &thing);
+   }
+
+   // MirrorThing might have moved the mirror of this thing             
+   mMirror[&thing].mChildren = ::std::move(children);
+   return true;
+}
+
+/// Re-diff a slice of the hierarchy, continuing where the last slice ended   
+/// The position is kept as indices of children, rather than pointers, so     
+/// it's safe to follow even after Things were removed - at worst, a Thing    
+/// is visited once more, or once less, in that pass                          
+///   @return true if anything changed                                        
+bool GUIEditor::SweepHierarchy() {
+   const auto& owners = GetOwners();
+   bool changed = false;
+   uint32_t visited = 0;
+   while (visited < SweepBudget) {
+      // Follow the path, as far as it still leads                      
+      const Thing* thing {};
+      size_t depth = 0;
+      for (; depth < mSweepPath.size(); ++depth) {
+         const auto index = mSweepPath[depth];
+         if (depth == 0) {
+            if (index >= owners.GetCount())
+               break;
+            thing = &*owners[index];
+         }
+         else {
+            const auto& children = thing->GetChildren();
+            if (index >= children.GetCount())
+               break;
+            thing = &*children[index];
+         }
+      }
+
+      if (depth < mSweepPath.size()) {
+         // Out of siblings - continue after the parent, or start the   
+         // next pass on the next update, once out of owners            
+         mSweepPath.resize(depth);
+         if (mSweepPath.empty()) {
+            mSweepPath.push_back(0);
+            break;
+         }
+         ++mSweepPath.back();
+         continue;
+      }
+
+      // Things that aren't mirrored yet will be, along with their      
+      // parents                                                        
+      if (mMirror.contains(thing))
+         changed |= ReconcileThing(*thing);
+      ++visited;
+
+      // Continue with the first child, or with the next sibling        
+      if (not thing->GetChildren().IsEmpty())
+         mSweepPath.push_back(0);
+      else
+         ++mSweepPath.back();
+   }
+   return changed;
+}
+
+/// Apply the changes of the hierarchy to the mirror and the index, on the    
+/// main thread - the only one that touches the hierarchy                     
+/// Owners report their own changes, and are reconciled as soon as they do,   
+/// but nothing is reported from below them, so the rest of the hierarchy     
+/// is swept for changes, a slice on each update                              
+///   @return true if anything changed                                        
+bool GUIEditor::ReconcileHierarchy() {
+   ::std::lock_guard lock {mHierarchyMutex};
+   bool changed = false;
+   if (mHierarchyStale.exchange(false, ::std::memory_order_acquire)) {
+      ::std::vector<const void*> roots;
+      for (auto& owner : GetOwners())
+         roots.push_back(&*owner);
+
+      for (auto root : mMirrorRoots) {
+         if (::std::find(roots.begin(), roots.end(), root) == roots.end()) {
+            ForgetThing(root);
+            changed = true;
+         }
+      }
+
+      for (auto& owner : GetOwners()) {
+         if (mMirror.contains(&*owner))
+            changed |= ReconcileThing(*owner);
+         else {
+            MirrorThing(*owner, nullptr);
+            changed = true;
+         }
+      }
+      mMirrorRoots = ::std::move(roots);
+   }
+
+   changed |= SweepHierarchy();
+   if (changed)
+      mMirrorChanged = true;
+   return changed;
+}
+
+/// Catch up with the changes of the mirror, if there were any, and reveal    
+/// the match of an associated query                                          
+/// Has to be called by the renderer, while holding mHierarchyMutex           
+void GUIEditor::FollowMirror() {
+   if (mMirrorChanged) {
+      mMirrorChanged = false;
+      mHierarchy.Refresh();
+
+      // Matches might refer to entries that were just removed          
+      mMatches.clear();
+      mMatchCount = 0;
+      mFilterQuery = mFilterInput;
+      if (not mFilterInput.empty())
+         mMatchCount = mIndex.Find(mFilterInput, mMatches, MaxMatches);
+   }
+
+   if (mRevealPending) {
+      mRevealPending = false;
+      ::std::vector<uint32_t> matches;
+      if (mIndex.Find(mRevealQuery, matches, 1))
+         RevealMatch(matches.front());
+   }
+}
+
+/// Search the mirrored hierarchy, the way the filter does                    
+///   @param query - the text to search for                                   
+///   @return the names and types of the first matches                        
+auto GUIEditor::Find(::std::string_view query) -> TMany<Text> {
+   ::std::lock_guard lock {mHierarchyMutex};
+   ::std::vector<uint32_t> matches;
+   mIndex.Find(query, matches, MaxMatches);
+
+   TMany<Text> labels;
+   for (auto match : matches)
+      labels << Text {Token {mIndex.GetTerm(match)}};
+   return labels;
+}
+
+/// Reveal the first match of a query in the tree, expanding everything on    
+/// the way to it, as if it was picked from the filtered matches              
+/// The renderer reveals it, when it renders next                             
+///   @param query - the text to search for                                   
+void GUIEditor::Reveal(::std::string_view query) {
+   {
+      ::std::lock_guard lock {mHierarchyMutex};
+      mRevealQuery = query;
+      mRevealPending = true;
+   }
+   GetProducer()->Invalidate();
+}
+
+/// Describe the current children of a tree node, as mirrored               
+/// The root's children are the owners of the editor, a Thing's children are  
+/// its child Things, followed by its units and traits. Called only by the    
+/// renderer, while holding mHierarchyMutex - keys are never dereferenced,    
+/// so the hierarchy itself is never touched off the main thread              
+///   @param tree - the tree to describe to                                   
+///   @param node - the node to describe the children of                      
+void GUIEditor::PopulateTree(TreeView& tree, uint32_t node) {
+   // The list is reused, so it only grows the first few times, and     
+   // labels are viewed in the mirror, which doesn't change meanwhile   
+   auto& children = mPopulateChildren;
+   children.clear();
+   const auto addThing = [&](const void* key) {
+      const auto found = mMirror.find(key);
+      if (found == mMirror.end())
+         return;
+
+      const auto& mirror = found->second;
+      const bool expandable = not mirror.mChildren.empty()
+         or not mirror.mMembers.empty();
+      children.push_back({key, mirror.mLabel, NodeThing, expandable});
+   };
+
+   if (node == TreeView::Root) {
+      for (auto key : mMirrorRoots)
+         addThing(key);
+   }
+   else if (tree.Get(node).mKind == NodeThing) {
+      const auto found = mMirror.find(tree.Get(node).mKey);
+      if (found != mMirror.end()) {
+         for (auto child : found->second.mChildren)
+            addThing(child);
+         for (auto& member : found->second.mMembers)
+            children.push_back({member.mKey, member.mLabel, member.mKind, false});
+      }
+   }
+   tree.Sync(node, children);
+
+   if (node != TreeView::Root)
+      return;
+
+   // Owners are shown expanded, when they first appear                 
+   const auto rows = tree.Get(TreeView::Root).mChildren;
+   for (auto row : rows) {
+      const auto key = tree.Get(row).mKey;
+      if (::std::find(mOwnersShown.begin(), mOwnersShown.end(), key) != mOwnersShown.end())
+         continue;
+      mOwnersShown.push_back(key);
+      tree.Expand(row, true);
+   }
+}
+
+/// Scroll the tree just enough to keep the cursor visible                    
+///   @param count - number of rows                                           
+///   @return the number of rows that fit in the tree's area                  
+int GUIEditor::ScrollTree(int count) {
+   const int rows = ::std::max(mTreeBox.y_max - mTreeBox.y_min + 1, 1);
+   mTreeCursor = ::std::clamp(mTreeCursor, 0, ::std::max(count - 1, 0));
+   if (mTreeCursor < mTreeScroll)
+      mTreeScroll = mTreeCursor;
+   else if (mTreeCursor >= mTreeScroll + rows)
+      mTreeScroll = mTreeCursor - rows + 1;
+   mTreeScroll = ::std::clamp(mTreeScroll, 0, ::std::max(count - rows, 0));
+   return rows;
+}
+
+/// Build elements for the tree rows that fit in the right panel              
+/// The cost depends only on the height of the panel, and on how much of the  
+/// hierarchy is expanded - never on the size of the hierarchy itself         
+///   @param focused - whether the tree has focus, to highlight the cursor    
+///   @return the tree element                                                
+Element GUIEditor::RenderTree(bool focused) {
+   ::std::lock_guard lock {mHierarchyMutex};
+   FollowMirror();
+
+   if (not mFilterInput.empty())
+      return RenderMatches(focused);
+
+   const auto& nodes = mHierarchy.GetRows();
+   const int count = static_cast<int>(nodes.size());
+   const int end = ::std::min(mTreeScroll + ScrollTree(count), count);
+   Elements lines;
+   lines.reserve(::std::max(end - mTreeScroll, 0));
+   for (int i = mTreeScroll; i < end; ++i) {
+      const auto& node = mHierarchy.Get(nodes[i]);
+      const char* marker = not node.mExpandable ? "  " : node.mExpanded ? "▾ " : "▸ ";
+      auto element = hbox({
+         text(::std::string((node.mDepth - 1) * 2, ' ')),
+         text(marker),
+         text(node.mLabel)
+      });
+
+      if (node.mKind == NodeUnit)
+         element |= color(Color::Cyan);
+      else if (node.mKind == NodeTrait)
+         element |= color(Color::GrayLight);
+      if (i == mTreeCursor)
+         element |= focused ? inverted : bold;
+      lines.push_back(::std::move(element));
+   }
+
+   return vbox(::std::move(lines)) | reflect(mTreeBox);
+}
+
+/// Build elements for the visible objects that match the filter              
+/// Matches are looked up in the index only when the query changes            
+///   @param focused - whether the tree has focus, to highlight the cursor    
+///   @return the matches element                                             
+Element GUIEditor::RenderMatches(bool focused) {
+   if (mFilterQuery != mFilterInput) {
+      mMatchCount = mIndex.Find(mFilterInput, mMatches, MaxMatches);
+      mFilterQuery = mFilterInput;
+      mTreeCursor = 0;
+   }
+
+   const int count = static_cast<int>(mMatches.size());
+   const int end = ::std::min(mTreeScroll + ScrollTree(count), count);
+   Elements lines;
+   lines.reserve(::std::max(end - mTreeScroll, 0));
+   for (int i = mTreeScroll; i < end; ++i) {
+      const auto& entry = mIndex.Get(mMatches[i]);
+
+      // Show where the match is, by the names of its closest owners    
+      ::std::string path;
+      auto owner = mIndex.FindEntry(entry.mParent);
+      for (int depth = 0; owner and depth < 3; ++depth) {
+         path.insert(0, ::std::string {mIndex.GetTerm(*owner)} + "/");
+         owner = mIndex.FindEntry(owner->mParent);
+      }
+      if (owner)
+         path.insert(0, ".../");
+
+      auto element = hbox({
+         text(path) | dim,
+         text(::std::string {mIndex.GetTerm(mMatches[i])})
+      });
+
+      if (entry.mKind == NodeUnit)
+         element |= color(Color::Cyan);
+      else if (entry.mKind == NodeTrait)
+         element |= color(Color::GrayLight);
+      if (i == mTreeCursor)
+         element |= focused ? inverted : bold;
+      lines.push_back(::std::move(element));
+   }
+
+   auto summary = text(" " + ::std::to_string(mMatchCount) + " matches"
+      + (mMatchCount > mMatches.size() ? ", first " + ::std::to_string(mMatches.size()) + " listed " : " "))
+      | dim;
+
+   return vbox({
+      vbox(::std::move(lines)) | yflex_grow | reflect(mTreeBox),
+      summary
+   });
+}
+
+/// Clear the filter, and reveal a match in the tree, expanding all the       
+/// nodes on the way to it                                                    
+///   @param match - the match to reveal                                      
+void GUIEditor::RevealMatch(uint32_t match) {
+   ::std::vector<TreeView::Key> path;
+   for (auto key = mIndex.Get(match).mKey; key;) {
+      path.push_back(key);
+      const auto entry = mIndex.FindEntry(key);
+      key = entry ? entry->mParent : nullptr;
+   }
+   ::std::reverse(path.begin(), path.end());
+
+   mFilterInput.clear();
+   mFilterQuery.clear();
+   const auto node = mHierarchy.Reveal(path);
+   const auto& rows = mHierarchy.GetRows();
+   const auto found = ::std::find(rows.begin(), rows.end(), node);
+   mTreeCursor = found == rows.end() ? 0 : static_cast<int>(found - rows.begin());
+}
+
+/// Move around the tree, expand or collapse nodes                            
+/// While filtering, move around the matches, and reveal them in the tree     
+///   @param event - the event to react to                                    
+///   @return true if the event was handled                                   
+bool GUIEditor::NavigateTree(const Event& event) {
+   ::std::lock_guard lock {mHierarchyMutex};
+   FollowMirror();
+
+   const bool filtering = not mFilterInput.empty();
+   const auto& nodes = mHierarchy.GetRows();
+   const int count = static_cast<int>(filtering ? mMatches.size() : nodes.size());
+   if (count == 0)
+      return false;
+
+   const int page = ::std::max(mTreeBox.y_max - mTreeBox.y_min, 1);
+   const int cursor = ::std::clamp(mTreeCursor, 0, count - 1);
+   if (event == Event::ArrowUp)
+      mTreeCursor -= 1;
+   else if (event == Event::ArrowDown)
+      mTreeCursor += 1;
+   else if (event == Event::PageUp)
+      mTreeCursor -= page;
+   else if (event == Event::PageDown)
+      mTreeCursor += page;
+   else if (event == Event::Home)
+      mTreeCursor = 0;
+   else if (event == Event::End)
+      mTreeCursor = count - 1;
+   else if (filtering and event == Event::Return)
+      RevealMatch(mMatches[cursor]);
+   else if (not filtering and (event == Event::ArrowRight or event == Event::Return))
+      mHierarchy.Expand(nodes[cursor], true);
+   else if (not filtering and event == Event::ArrowLeft) {
+      const auto& node = mHierarchy.Get(nodes[cursor]);
+      if (node.mExpanded)
+         mHierarchy.Expand(nodes[cursor], false);
+      else if (node.mParent != TreeView::Root) {
+         // Jump to the parent                                          
+         const auto parent = ::std::find(nodes.begin(), nodes.end(), node.mParent);
+         mTreeCursor = static_cast<int>(parent - nodes.begin());
+      }
+   }
+   else if (event.is_mouse() and (event.mouse().button == Mouse::WheelUp
+                              or event.mouse().button == Mouse::WheelDown)) {
+      // Wheel scrolling moves the view, dragging the cursor along      
+      const int rows = ::std::max(mTreeBox.y_max - mTreeBox.y_min + 1, 1);
+      mTreeScroll += event.mouse().button == Mouse::WheelUp ? -3 : 3;
+      mTreeScroll = ::std::clamp(mTreeScroll, 0, ::std::max(count - rows, 0));
+      mTreeCursor = ::std::clamp(mTreeCursor, mTreeScroll, mTreeScroll + rows - 1);
+   }
+   else if (event.is_mouse() and event.mouse().button == Mouse::Left
+   and event.mouse().motion == Mouse::Pressed
+   and mTreeBox.Contain(event.mouse().x, event.mouse().y)) {
+      // Select the clicked row, and toggle or reveal it, if clicked    
+      // again                                                          
+      const int row = mTreeScroll + event.mouse().y - mTreeBox.y_min;
+      if (row >= count)
+         return false;
+      if (row == mTreeCursor and filtering) {
+         RevealMatch(mMatches[row]);
+         return true;
+      }
+      if (row == mTreeCursor)
+         mHierarchy.Expand(nodes[row], not mHierarchy.Get(nodes[row]).mExpanded);
+      mTreeCursor = row;
+   }
+   else
+      return false;
+
+   // Clamped when rendering, where the view also follows the cursor    
+   return true;
+}
+
 /// React on environmental change                                             
+/// The owners changed - only mark them as stale, their changes are applied   
+/// on the next update                                                        
 void GUIEditor::Refresh() {
-
+   mHierarchyStale.store(true, ::std::memory_order_release);
+   if (auto system = GetProducer())
+      system->Invalidate();
 }
 
@@ -7,36 +7,105 @@
 ///                                                                           
 #pragma once
 #include "Common.hpp"
+#include "Console.hpp"
+#include "SearchIndex.hpp"
+#include "TreeView.hpp"
 #include <Langulus/Flow/Producible.hpp>
 #include <ftxui/component/component_base.hpp>
 #include <ftxui/dom/elements.hpp>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
+class LineNode;
 
 ///                                                                           
-///   GUI item                                                                
+///   Log sink                                                                
 ///                                                                           
-/// A single widget inside of a GUI system                                    
+///   A Logger attachment, that queues whatever gets logged, from any thread, 
+/// without locking, and without touching the terminal. The editor drains it  
+/// in batches on its own thread, once per frame.                             
+///                                                                           
+struct LogSink final : Logger::A::Interface {
+   mutable LogQueue mQueue;
+
+   LogSink(uint32_t fragments)
+      : mQueue {fragments} {}
+
+   void Write(const TextView&) const noexcept override;
+   void Write(const Logger::Style&) const noexcept override;
+   void NewLine() const noexcept override;
+   void Clear() const noexcept override;
+};
+
+
+///                                                                           
+///   GUI editor                                                              
+///                                                                           
+///   Log, flow console, statistics, and hierarchy of a GUI system, shown     
+/// below its image, when the system is created with the Editor trait         
 ///                                                                           
 struct GUIEditor final : A::UIUnit, ProducedFrom<GUISystem> {
    LANGULUS(ABSTRACT) false;
    LANGULUS(PRODUCER) GUISystem;
    LANGULUS_BASES(A::UIUnit);
 
+   /// Elements of the visible rows of a log, reused between renders          
+   struct LineCache {
+      ::std::vector<::std::shared_ptr<LineNode>> mRows;
+      ftxui::Element mElement;
+   };
+
+   /// A unit or a trait of a mirrored Thing                                  
+   struct MirrorMember {
+      const void* mKey;
+      ::std::string mLabel;
+      uint8_t mKind;
+   };
+
+   /// A Thing, as the main thread last saw it                                
+   struct Mirror {
+      const void* mParent {};
+      ::std::string mLabel;
+      ::std::vector<const void*> mChildren;
+      ::std::vector<MirrorMember> mMembers;
+   };
+
 private:
-   // The main terminal renderer and loop                               
-   ::std::vector<ftxui::Element> mLog;
+   // Most recent log lines, of which only the visible ones are turned  
+   // into elements when rendering                                      
+   LogRing mLog {LogLines, LogBytes};
+   // Lines logged from anywhere, waiting to be moved to mLog           
+   LogSink mLogSink {LogFragments};
 
    ftxui::Component mTabSelector;
    ftxui::Component mTabContents;
    int mSelectedTab = 0;
 
    ftxui::Component mLogTab;
-   int mLogScroll;
+   // Lines scrolled up from the newest line - zero follows the log     
+   int mLogScroll = 0;
+   // Area the log was rendered in last time                            
+   ftxui::Box mLogBox;
+   LineCache mLogLines;
+   // The log tab, and the status it was composed for                   
+   ftxui::Element mLogElement;
+   const ftxui::Node* mLogShown {};
+   uint64_t mLogDropped {};
+   int mLogScrolled {};
 
    ftxui::Component mFlowTab;
    ftxui::Component mFlowContents;
    ftxui::Component mFlowCommand;
    ::std::string    mFlowCommandInput;
+   // Results of commands, of which only the visible ones are built     
+   LogRing mFlowLog {FlowLines, FlowBytes};
+   int mFlowScroll = 0;
+   ftxui::Box mFlowBox;
+   LineCache mFlowLines;
+   // Age of the recalled command, or -1 while typing a new one         
+   int mFlowHistory = -1;
 
    ftxui::Component mLeftPanel;
 
@@ -44,6 +113,47 @@ private:
    ftxui::Component mTree;
    ftxui::Component mSelection;
 
+   // Set on hierarchy change notifications, the mirror is reconciled   
+   // on the next update, on the main thread                            
+   ::std::atomic<bool> mHierarchyStale {true};
+   // Guards the mirror and the index, which the main thread changes,   
+   // and the renderer reads                                            
+   ::std::mutex mHierarchyMutex;
+   // Every mirrored Thing, and the owners of the editor among them     
+   ::std::unordered_map<const void*, Mirror> mMirror;
+   ::std::vector<const void*> mMirrorRoots;
+   // Set when the mirror changed, until the renderer catches up        
+   bool mMirrorChanged = false;
+   // Index of the whole mirror, changed along with it                  
+   SearchIndex mIndex;
+   // Where the sweep of the hierarchy continues - indices of children, 
+   // starting with the index of an owner                               
+   ::std::vector<uint32_t> mSweepPath {0};
+   // Query whose first match the renderer reveals in the tree next     
+   ::std::string mRevealQuery;
+   bool mRevealPending = false;
+
+   // Tree of the mirror, populated by the renderer only where          
+   // expanded                                                          
+   TreeView mHierarchy {[this](TreeView& tree, uint32_t node) {
+      PopulateTree(tree, node);
+   }};
+   // Scratch list for describing children of a node to the tree        
+   ::std::vector<TreeView::Child> mPopulateChildren;
+   // Owners that were shown in the tree, and expanded the first time   
+   ::std::vector<const void*> mOwnersShown;
+   ftxui::Component mFilter;
+   ::std::string mFilterInput;
+   // The query mMatches were found for                                 
+   ::std::string mFilterQuery;
+   ::std::vector<uint32_t> mMatches;
+   uint32_t mMatchCount = 0;
+   // First visible row, and the row under the cursor                   
+   int mTreeScroll = 0;
+   int mTreeCursor = 0;
+   // Area the tree was rendered in last time                           
+   ftxui::Box mTreeBox;
+
    ftxui::Component mRenderer;
    ftxui::Component mMain;
    int mSplit = 30;
@@ -52,10 +162,64 @@ private:
    // Selected GUISystem                                                
    std::vector<std::string> mTabNames;
 
+   // Runs flow commands on its own thread - declared last, so it is    
+   // stopped before anything its commands might use is destroyed       
+   Console mConsole {[this](::std::string_view code) {
+      return ParseFlow(code);
+   }};
+
+   void DrainLog();
+   auto RenderLog() -> ftxui::Element;
+   bool ScrollLog(const ftxui::Event&);
+
+   bool ReconcileHierarchy();
+   bool SweepHierarchy();
+   bool ReconcileThing(const Thing&);
+   void MirrorThing(const Thing&, const void*);
+   void ForgetThing(const void*);
+   void FollowMirror();
+   void PopulateTree(TreeView&, uint32_t);
+   int  ScrollTree(int);
+   auto RenderTree(bool) -> ftxui::Element;
+   auto RenderMatches(bool) -> ftxui::Element;
+   void RevealMatch(uint32_t);
+   bool NavigateTree(const ftxui::Event&);
+
+   auto ParseFlow(::std::string_view) -> ::std::shared_ptr<Console::Script>;
+   void DrainFlow();
+   auto RenderFlow() -> ftxui::Element;
+   bool FlowInput(const ftxui::Event&);
+
+   auto RenderStats() -> ftxui::Element;
+
 public:
+   /// Kinds of hierarchy nodes                                               
+   enum NodeKind : uint8_t {
+      NodeThing, NodeUnit, NodeTrait
+   };
+
+   static constexpr uint32_t LogLines = 8192;
+   static constexpr uint32_t LogBytes = 1024 * 1024;
+   static constexpr uint32_t LogFragments = 4096;
+   static constexpr uint32_t LogBatch = 1024;
+   static constexpr uint32_t MaxMatches = 10000;
+   // Things below the owners re-diffed per update                      
+   static constexpr uint32_t SweepBudget = 256;
+   static constexpr uint32_t FlowLines = 2048;
+   static constexpr uint32_t FlowBytes = 256 * 1024;
+   // Time flow commands may spend running, per update                  
+   static constexpr auto FlowBudget = ::std::chrono::milliseconds {2};
+
    GUIEditor(GUISystem*, const Many&);
+   ~GUIEditor();
+
+   void Log(::std::string_view, Kernels::RGB8, uint8_t style = 0);
+   auto GetComponent() const noexcept -> const ftxui::Component&;
+   auto GetLogStats() const noexcept -> LogQueue::Stats;
+   auto Find(::std::string_view) -> TMany<Text>;
+   void Reveal(::std::string_view);
 
-   virtual void Update(Time) {}
+   virtual void Update(Time);
    void Refresh();
 };
 
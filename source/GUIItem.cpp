@@ -7,6 +7,82 @@
 ///                                                                           
 #include "GUIItem.hpp"
 #include "GUI.hpp"
+#include <ftxui/dom/node.hpp>
+#include <ftxui/dom/table.hpp>
+#include <algorithm>
+
+using namespace ftxui;
+
+
+///                                                                           
+///   Retained node                                                           
+///                                                                           
+///   Wraps the element of a widget, and keeps its measured requirement and   
+/// its laid out box between renders. The element is measured only after it   
+/// was replaced, and laid out only after that, or when given another box -   
+/// containers still ask for both on every render, but clean widgets answer   
+/// from the cache, without descending into their subtree.                    
+///                                                                           
+class RetainedNode : public Node {
+   bool mMeasured = false;
+   bool mPlaced = false;
+
+public:
+   /// Replace the retained element                                           
+   ///   @param element - the new element                                     
+   void Reset(Element element) {
+      children_.assign(1, ::std::move(element));
+      mMeasured = false;
+      mPlaced = false;
+   }
+
+   void ComputeRequirement() override {
+      if (mMeasured)
+         return;
+
+      Node::ComputeRequirement();
+      requirement_ = children_.front()->requirement();
+      mMeasured = true;
+   }
+
+   void SetBox(Box box) override {
+      if (mPlaced
+      and box.x_min == box_.x_min and box.x_max == box_.x_max
+      and box.y_min == box_.y_min and box.y_max == box_.y_max)
+         return;
+
+      Node::SetBox(box);
+      children_.front()->SetBox(box);
+      mPlaced = true;
+   }
+};
+
+/// Split text into the cells of a table                                      
+///   @param text - rows separated by new lines, and columns by tabs          
+///   @return the rows, all with the same number of columns                   
+::std::vector<::std::vector<::std::string>> SplitTable(::std::string_view text) {
+   ::std::vector<::std::vector<::std::string>> rows;
+   size_t columns = 0;
+   while (not text.empty()) {
+      const auto eol = text.find('\n');
+      auto line = text.substr(0, eol);
+      text = eol == text.npos ? ::std::string_view {} : text.substr(eol + 1);
+
+      auto& row = rows.emplace_back();
+      while (true) {
+         const auto tab = line.find('\t');
+         row.emplace_back(line.substr(0, tab));
+         if (tab == line.npos)
+            break;
+         line = line.substr(tab + 1);
+      }
+      columns = ::std::max(columns, row.size());
+   }
+
+   for (auto& row : rows)
+      row.resize(columns);
+   return rows;
+}
 
 
 /// GUI item construction                                                     
@@ -14,14 +90,151 @@
 ///   @param descriptor - instructions for configuring the item               
 GUIItem::GUIItem(GUISystem* producer, const Many& descriptor)
    : Resolvable   {this}
-   , ProducedFrom {producer, descriptor} {
+   , ProducedFrom {producer, descriptor}
+   , mDescriptor  {descriptor}
+   , mConfig      {Read()}
+   , mNode        {::std::make_shared<RetainedNode>()} {
    VERBOSE_GUI("Initializing...");
    Couple(descriptor);
    VERBOSE_GUI("Initialized");
 }
 
-/// React on environmental change                                             
-void GUIItem::Refresh() {
+/// Read the configuration of the widget from its current traits              
+/// Associated traits come first, then those the item was created with, and   
+/// then those in its hierarchy                                               
+///   @return the configuration                                               
+auto GUIItem::Read() const -> Config {
+   Config config;
+   Text widget;
+   if (not SeekValueAux<Traits::Widget>(mTraits, widget))
+      SeekValueAux<Traits::Widget>(mDescriptor, widget);
+   const Token kind {widget};
+   if (kind == "gauge")
+      config.mWidget = Widget::Gauge;
+   else if (kind == "table")
+      config.mWidget = Widget::Table;
+
+   Text caption;
+   if (not SeekValueAux<Traits::Caption>(mTraits, caption))
+      SeekValueAux<Traits::Caption>(mDescriptor, caption);
+   config.mCaption = ::std::string {Token {caption}};
+
+   if (not SeekValueAux<Traits::Progress>(mTraits, config.mProgress))
+      SeekValueAux<Traits::Progress>(mDescriptor, config.mProgress);
+   config.mProgress = ::std::clamp(config.mProgress, Real {0}, Real {1});
+   return config;
+}
+
+/// Build the element of a widget                                             
+///   @param config - the widget's configuration                              
+///   @return the element                                                     
+auto GUIItem::Build(const Config& config) -> Element {
+   switch (config.mWidget) {
+   case Widget::Gauge: {
+      const auto progress = static_cast<float>(config.mProgress);
+      return hbox({
+         text(config.mCaption + ' '),
+         gauge(progress) | flex,
+         text(' ' + ::std::to_string(static_cast<int>(progress * 100)) + '%')
+      });
+   }
+   case Widget::Table: {
+      auto rows = SplitTable(config.mCaption);
+      if (rows.empty())
+         return emptyElement();
+
+      Table table {::std::move(rows)};
+      table.SelectAll().Border(LIGHT);
+      table.SelectAll().SeparatorVertical(LIGHT);
+      table.SelectRow(0).Decorate(bold);
+      table.SelectRow(0).BorderBottom(LIGHT);
+      return table.Render();
+   }
+   default:
+      return text(config.mCaption);
+   }
+}
+
+/// Replace the configuration, if it differs                                  
+///   @param config - the new configuration                                   
+///   @return true if the configuration changed                               
+bool GUIItem::Configure(Config&& config) {
+   {
+      const ::std::lock_guard lock {mMutex};
+      if (config == mConfig)
+         return false;
+      mConfig = ::std::move(config);
+   }
 
+   mStale.store(true, ::std::memory_order_release);
+   return true;
 }
 
+/// Get the element of the widget, rebuilding it only if it went stale        
+/// Called by the thread that renders                                         
+///   @return the retained element                                            
+auto GUIItem::Render() -> Element {
+   if (mStale.exchange(false, ::std::memory_order_acq_rel)) {
+      Config config;
+      {
+         const ::std::lock_guard lock {mMutex};
+         config = mConfig;
+      }
+      mNode->Reset(Build(config));
+   }
+   return mNode;
+}
+
+/// Associate traits with the item, overriding those it had                   
+/// Only the widget, caption, and progress are taken - they are read on the   
+/// next update, along with the rest                                          
+///   @param verb - the association verb                                      
+void GUIItem::Associate(Verb& verb) {
+   Many traits;
+   verb.ForEachDeep([&](const Trait& trait) {
+      if (trait.template IsTrait<Traits::Widget>()
+      or  trait.template IsTrait<Traits::Caption>()
+      or  trait.template IsTrait<Traits::Progress>())
+         traits << trait;
+   });
+
+   if (traits.IsEmpty())
+      return;
+
+   // Keep the previously associated traits that weren't overridden     
+   mTraits.ForEachDeep([&](const Trait& previous) {
+      bool overridden = false;
+      traits.ForEachDeep([&](const Trait& trait) {
+         overridden |= trait.GetTrait() == previous.GetTrait();
+      });
+      if (not overridden)
+         traits << previous;
+   });
+
+   mTraits = ::std::move(traits);
+   mChanged = true;
+   verb.Done();
+}
+
+/// Read the traits again, if they might have changed                         
+/// Called by the system on the main thread, while it holds its items. The    
+/// widget is rebuilt, and the system asked to render again, only if the      
+/// traits actually changed                                                   
+void GUIItem::Update(Time) {
+   if (not mChanged)
+      return;
+
+   mChanged = false;
+   if (not Configure(Read()))
+      return;
+
+   if (auto system = GetProducer())
+      system->Invalidate();
+}
+
+/// React on environmental change                                             
+/// The hierarchy might have other traits now - they are read on the next     
+/// update                                                                    
+void GUIItem::Refresh() {
+   mChanged = true;
+}
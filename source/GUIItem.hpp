@@ -8,22 +8,72 @@
 #pragma once
 #include "Common.hpp"
 #include <Langulus/Flow/Producible.hpp>
+#include <Langulus/Verbs/Associate.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+class RetainedNode;
 
 
 ///                                                                           
 ///   GUI item                                                                
 ///                                                                           
-/// A single widget inside of a GUI system                                    
+///   A single retained widget inside of a GUI system - a label, a gauge, or  
+/// a table, built from the item's traits. Traits associated with the item    
+/// override those it was created with, and those in its hierarchy. The       
+/// built element and its measured layout are kept between renders, and       
+/// rebuilt only when the traits actually change, so that the rest of the     
+/// tree isn't reflowed.                                                      
 ///                                                                           
 struct GUIItem final : A::UIUnit, ProducedFrom<GUISystem> {
    LANGULUS(ABSTRACT) false;
    LANGULUS(PRODUCER) GUISystem;
    LANGULUS_BASES(A::UIUnit);
+   LANGULUS_VERBS(Verbs::Associate);
+
+   /// Kinds of widgets                                                       
+   enum class Widget : uint8_t {
+      Label,   // A line of text
+      Gauge,   // A caption, followed by a progress bar
+      Table    // Rows separated by new lines, columns by tabs
+   };
+
+private:
+   /// What a widget is built from                                            
+   struct Config {
+      Widget mWidget = Widget::Label;
+      ::std::string mCaption;
+      Real mProgress {};
+
+      bool operator == (const Config&) const = default;
+   };
+
+   // Instructions the item was created with, through which traits      
+   // are also sought in the hierarchy                                  
+   Many mDescriptor;
+   // Traits associated with the item since, overriding the rest        
+   Many mTraits;
+   // Set when traits might have changed, read again on next update     
+   bool mChanged = false;
+   // The configuration is written by the main thread, and read by the  
+   // thread that renders                                               
+   mutable ::std::mutex mMutex;
+   Config mConfig;
+   // Set when the configuration changed since the widget was built     
+   ::std::atomic<bool> mStale {true};
+   // Retains the built widget and its measured layout                  
+   ::std::shared_ptr<RetainedNode> mNode;
+
+   auto Read() const -> Config;
+   static auto Build(const Config&) -> ftxui::Element;
+   bool Configure(Config&&);
 
 public:
    GUIItem(GUISystem*, const Many&);
 
-   virtual void Update(Time) {}
+   void Associate(Verb&);
+   auto Render() -> ftxui::Element;
+   virtual void Update(Time);
    void Refresh();
 };
-
@@ -7,12 +7,124 @@
 ///                                                                           
 #include "GUISystem.hpp"
 #include "GUI.hpp"
+#include <Langulus/Input.hpp>
+#include <Langulus/Verbs/Interact.hpp>
 #include <Langulus/Math/Color.hpp>
 #include <ftxui/screen/color.hpp>
+#include <ftxui/screen/terminal.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+   #ifndef WIN32_LEAN_AND_MEAN
+      #define WIN32_LEAN_AND_MEAN
+   #endif
+   #ifndef NOMINMAX
+      #define NOMINMAX
+   #endif
+   #include <windows.h>
+#else
+   #include <poll.h>
+   #include <unistd.h>
+#endif
+
+static_assert(sizeof(Math::RGBAf) == sizeof(float) * 4,
+   "Conversion kernels expect tightly packed RGBA float colors");
+static_assert(sizeof(Logger::Emphasis) == 1,
+   "Translation kernels expect emphasis to be a single byte of flags");
 
 using namespace ftxui;
 
 
+/// Get a timestamp, for measuring durations                                  
+///   @return nanoseconds since an arbitrary point in time                    
+uint64_t Stamp() noexcept {
+   return static_cast<uint64_t>(::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+      ::std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// Convert a duration to the units of Stamp                                  
+///   @param time - the duration                                              
+///   @return the duration in nanoseconds                                     
+uint64_t Nanoseconds(Time time) noexcept {
+   return static_cast<uint64_t>(::std::chrono::duration_cast<
+      ::std::chrono::nanoseconds>(time).count());
+}
+
+/// Mix a 64bit word into a running hash                                      
+///   @param h - the running hash                                             
+///   @param w - the word to mix in                                           
+///   @return the new hash                                                    
+constexpr uint64_t HashMix(uint64_t h, uint64_t w) noexcept {
+   h ^= w * 0x9E3779B97F4A7C15ull;
+   h = (h << 31) | (h >> 33);
+   return h * 0xBF58476D1CE4E5B9ull;
+}
+
+/// Mix an arbitrary sequence of bytes into a running hash                    
+///   @param h - the running hash                                             
+///   @param data - the bytes to mix in                                       
+///   @param size - number of bytes                                           
+///   @return the new hash                                                    
+uint64_t HashMix(uint64_t h, const void* data, size_t size) noexcept {
+   auto bytes = static_cast<const uint8_t*>(data);
+   uint64_t w;
+   while (size >= sizeof(w)) {
+      ::std::memcpy(&w, bytes, sizeof(w));
+      h = HashMix(h, w);
+      bytes += sizeof(w);
+      size  -= sizeof(w);
+   }
+
+   w = 0;
+   if (size)
+      ::std::memcpy(&w, bytes, size);
+   return HashMix(h, w ^ (static_cast<uint64_t>(size) << 56));
+}
+
+/// Hash a single row of an ASCII image                                       
+///   @param seed - anything else that affects how the row is converted       
+///   @param colors - the background colors of the row                        
+///   @param fg - the foreground colors of the row, or the colors of the      
+///               pixels below, when drawing half blocks - can be nullptr     
+///   @param symbols - the symbols of the row, can be nullptr                 
+///   @param styles - the emphasis of the row, can be nullptr                 
+///   @param width - number of cells in the row                               
+///   @return the hash, never zero, because zero marks an invalid row         
+uint64_t HashRow(
+   uint64_t seed, const Math::RGBAf* colors, const Math::RGBAf* fg,
+   const ::std::string_view* symbols, const Logger::Emphasis* styles,
+   uint32_t width
+) noexcept {
+   auto h = HashMix(HashMix(seed, width), colors, sizeof(Math::RGBAf) * width);
+   if (fg)
+      h = HashMix(h, fg, sizeof(Math::RGBAf) * width);
+   if (styles)
+      h = HashMix(h, styles, sizeof(Logger::Emphasis) * width);
+   if (symbols) {
+      for (uint32_t x = 0; x < width; ++x)
+         h = HashMix(h, symbols[x].data(), symbols[x].size());
+   }
+   return h ? h : 1;
+}
+
+
+/// Check if there's terminal input that wasn't read yet, without blocking    
+///   @return true if there's input pending                                   
+bool HasPendingInput() noexcept {
+#if defined(_WIN32)
+   DWORD events = 0;
+   return GetNumberOfConsoleInputEvents(GetStdHandle(STD_INPUT_HANDLE), &events)
+      and events > 0;
+#else
+   pollfd input {STDIN_FILENO, POLLIN, 0};
+   return poll(&input, 1, 0) > 0;
+#endif
+}
+
+
 /// GUI system construction                                                   
 ///   @param producer - the system producer                                   
 ///   @param descriptor - instructions for configuring the GUI                
@@ -20,22 +132,86 @@ GUISystem::GUISystem(GUI* producer, const Many& descriptor)
    : Resolvable   {this}
    , ProducedFrom {producer, descriptor}
    , mScreen      {ScreenInteractive::Fullscreen()}
-   , mBackbuffer  {1, 1} {
+   , mPool        {&producer->GetPool()}
+   , mConvert     {Kernels::GetConvertKernel().mFunction}
+   , mTranslate   {Kernels::GetTranslateKernel().mFunction} {
    VERBOSE_GUI("Initializing...");
+   VERBOSE_GUI("Using ", Kernels::GetConvertKernel().mName, " conversion kernel");
+
+   // Configure the color depth - palette lookup tables are built here, 
+   // once, and not when drawing the first frame                        
+   uint32_t colors = 0;
+   bool dither = false;
+   SeekValueAux<Traits::Colors>(descriptor, colors);
+   SeekValueAux<Traits::Dither>(descriptor, dither);
+   switch (colors) {
+   case 256:
+      mPalette = Palette {ColorDepth::Colors256, dither};
+      VERBOSE_GUI("Quantizing to 256 colors");
+      break;
+   case 16:
+      mPalette = Palette {ColorDepth::Colors16, dither};
+      VERBOSE_GUI("Quantizing to 16 colors");
+      break;
+   default:
+      break;
+   }
+
+   // Optionally draw color-only images with two pixels per cell, so    
+   // that the vertical resolution doubles for the same output          
+   SeekValueAux<Traits::HalfBlocks>(descriptor, mHalfBlocks);
+   mHalfBlock = mGlyphs.Intern("▀");
+
+   // Create the component tree - the image, with items over it         
+   Component display = Renderer([&] {
+      LANGULUS(PROFILE);
+      Emit();
+
+      // The element only refers to the image, so it is built once for  
+      // each pooled image, and not on every render                     
+      if (not mOutput->mElement)
+         mOutput->mElement = image(&mOutput->mImage) | flex;
+      return Compose();
+   });
+
+   // Optionally show the editor below the image, in a resizable split. 
+   // FTXUI has to draw both, so frames can't be written directly       
+   bool editor = false;
+   SeekValueAux<Traits::Editor>(descriptor, editor);
+   if (editor) {
+      mEditor = new GUIEditor(this, descriptor);
+      mDirectOutput.store(false, ::std::memory_order_release);
+      display = ResizableSplitBottom(mEditor->GetComponent(), display, &mEditorSize);
+   }
+
+   mRoot = display | CatchEvent([&](Event event) -> bool {
+      CatchInput(event);
+      return false;
+   });
+
+   // The loop runs only when something changes, but never stays idle   
+   // longer than this - zero runs it on every update                   
+   SeekValueAux<Traits::KeepAlive>(descriptor, mKeepAlive);
+
+   // In headless mode, the tree is rendered to a fixed size screen in  
+   // memory, and the terminal is never touched                         
+   SeekValueAux<Traits::Headless>(descriptor, mHeadless);
+   if (mHeadless) {
+      Scale2 size {80, 24};
+      SeekValueAux<Traits::Size>(descriptor, size);
+      ResizeOffscreen(size);
+      mSettledSize = mSettlingSize = mTerminalSize;
+      Render(mOffscreen, mRoot->Render());
+      Couple(descriptor);
+      VERBOSE_GUI("Initialized headless, ", mOffscreen.width(), "x", mOffscreen.height());
+      return;
+   }
 
    // Create the main loop                                              
    try {
       // Create the loop and immediately yield, so that we get proper   
       // screen size and other parameters                               
-      mLoop = new ftxui::Loop(&mScreen, Renderer([&] {
-         LANGULUS(PROFILE);
-         return image(&mBackbuffer) | flex;
-      }) | CatchEvent([&](Event event) -> bool {
-         //if (event.is_mouse())
-            //Logger::Special("mouse event"); //this works, but useful only for keyboard
-         return false;
-      }));
-
+      mLoop = new ftxui::Loop(&mScreen, mRoot);
       mLoop->RunOnce();
    }
    catch (const std::exception& e) {
@@ -43,12 +219,30 @@ GUISystem::GUISystem(GUI* producer, const Many& descriptor)
       throw;
    }
 
+   mTerminalSize = Terminal::Size();
+   mSettledSize = mSettlingSize = mTerminalSize;
+
+   // Optionally hand the loop over to a dedicated terminal I/O thread, 
+   // so that slow terminals never stall the main thread                
+   SeekValueAux<Traits::Threaded>(descriptor, mThreaded);
+   if (mThreaded) {
+      VERBOSE_GUI("Running terminal loop on a dedicated thread");
+      mThread = ::std::thread {&GUISystem::RunTerminal, this};
+   }
+
    Couple(descriptor);
    VERBOSE_GUI("Initialized");
 }
 
 /// Shutdown the module                                                       
 GUISystem::~GUISystem() {
+   if (mThread.joinable()) {
+      // Wake the loop up, so that it notices it has to stop            
+      mStop.store(true, ::std::memory_order_release);
+      mScreen.PostEvent(Event::Custom);
+      mThread.join();
+   }
+
    if (mEditor)
       delete mEditor;
    if (mLoop)
@@ -57,13 +251,49 @@ GUISystem::~GUISystem() {
 
 /// First stage destruction                                                   
 void GUISystem::Teardown() {
+   const ::std::lock_guard lock {mItemsMutex};
    mItems.Teardown();
+   ++mItemsVersion;
 }
 
 /// Produce GUI elements in the system                                        
+/// Once there are items, frames are no longer written to the terminal        
+/// directly, because FTXUI has to lay the items over them                    
 ///   @param verb - creation verb to satisfy                                  
 void GUISystem::Create(Verb& verb) {
-   mItems.Create(this, verb);
+   {
+      const ::std::lock_guard lock {mItemsMutex};
+      mItems.Create(this, verb);
+      ++mItemsVersion;
+   }
+
+   mDirectOutput.store(false, ::std::memory_order_release);
+   Invalidate();
+}
+
+/// Lay the items over the displayed image                                    
+/// Called by the thread that renders. The composition is reused as long as   
+/// no items were created or destroyed, and only items that went stale are    
+/// rebuilt - the rest answer with their retained elements and layouts        
+///   @return the element to render                                           
+auto GUISystem::Compose() -> Element {
+   const ::std::lock_guard lock {mItemsMutex};
+   if (mComposedVersion == mItemsVersion and mComposedOutput == mOutput) {
+      for (auto& item : mItems)
+         item.Render();
+      return mComposed;
+   }
+
+   mComposedVersion = mItemsVersion;
+   mComposedOutput = mOutput;
+   mComposedItems.clear();
+   for (auto& item : mItems)
+      mComposedItems.push_back(item.Render());
+
+   mComposed = mComposedItems.empty()
+      ? mOutput->mElement
+      : dbox({mOutput->mElement, vbox(mComposedItems)});
+   return mComposed;
 }
 
 /// System update routine                                                     
@@ -71,24 +301,544 @@ void GUISystem::Create(Verb& verb) {
 ///   @return false if the system has been terminated by user request         
 bool GUISystem::Update(Time deltaTime) {
    LANGULUS(PROFILE);
-   if (mLoop and mLoop->HasQuitted())
+   if (mEditor)
+      mEditor->Update(deltaTime);
+
+   if (mThreaded) {
+      // The loop runs on its own thread, just collect its results      
+      if (mQuit.load(::std::memory_order_acquire))
+         return false;
+
+      mTerminalSize = Terminal::Size();
+      SettleSize();
+   }
+   else if (mHeadless) {
+      // Present to memory, and run FTXUI on the offscreen screen, if   
+      // a real terminal would've been redrawn, or the loop would've    
+      // run anyway. The screen is turned to text only when asked for   
+      mEncoded.clear();
+      mOffscreenDirty = false;
+      SettleSize();
+      Present();
+      mIdle += deltaTime;
+      if (mRedraw or mIdle >= mKeepAlive) {
+         mRedraw = false;
+         mIdle = {};
+         const auto start = Stamp();
+         Render(mOffscreen, mRoot->Render());
+         mStats.mLayout.Record(Stamp() - start);
+         mOffscreenDirty = true;
+      }
+   }
+   else {
+      if (mLoop and mLoop->HasQuitted())
+         return false;
+
+      // Run the loop only if there's something for it to do, or if it  
+      // has been idle for too long                                     
+      mIdle += deltaTime;
+      const auto reasons = CollectChanges();
+      const bool settled = SettleSize();
+      const bool lingering = Stamp() < mInputUntil;
+      if (not reasons and not settled and not lingering and mIdle < mKeepAlive) {
+         ++mIdleUpdates;
+         return true;
+      }
+
+      mIdle = {};
+      if (reasons & ChangedSize) {
+         // Whatever the terminal displays after a resize is unknown    
+         mEncoder.Invalidate();
+      }
+
+      // Present any newly drawn frame, and yield FTXUI                 
+      Present();
+      const auto start = Stamp();
+      mLoop->RunOnce();
+      mStats.mLayout.Record(Stamp() - start);
+
+      // The loop might still hold input that it read - an escape key   
+      // is told apart from an escape sequence only after a while - so  
+      // it keeps running for a bit after any input                     
+      if (reasons & ChangedInput)
+         mInputUntil = Stamp() + Nanoseconds(mInputLinger);
+   }
+
+   // Take the batch of input events that arrived since last update,    
+   // and deliver it all at once                                        
+   if (mInputBatch.Take(mInput)) {
+      mStats.mInput.Record(mInput.size());
+      Dispatch();
+   }
+
+   // Update all UI elements, while the thread that renders can't       
+   const ::std::lock_guard lock {mItemsMutex};
+   for (auto& item : mItems)
+      item.Update(deltaTime);
+   return true;
+}
+
+/// Terminal I/O thread routine, used only in threaded mode                   
+/// Blocks until there's something for the loop to do - either input, or a    
+/// new frame, and runs the loop once for each such wake-up                   
+void GUISystem::RunTerminal() {
+   while (not mStop.load(::std::memory_order_acquire)) {
+      mLoop->RunOnceBlocking();
+      if (mLoop->HasQuitted()) {
+         mQuit.store(true, ::std::memory_order_release);
+         break;
+      }
+   }
+}
+
+/// Check what changed since the loop last ran                                
+/// Input is either waiting in the terminal, or was caught by the loop last   
+/// time it ran, in which case more of it might be queued in the loop         
+///   @return a combination of Changes, zero if nothing changed               
+auto GUISystem::CollectChanges() -> uint8_t {
+   auto changes = mChanges.exchange(0, ::std::memory_order_acq_rel);
+   if (mFrames.HasFresh())
+      changes |= ChangedFrame;
+   if (HasPendingInput())
+      changes |= ChangedInput;
+
+   const auto size = Terminal::Size();
+   if (size.dimx != mTerminalSize.dimx or size.dimy != mTerminalSize.dimy) {
+      mTerminalSize = size;
+      changes |= ChangedSize;
+   }
+   return changes;
+}
+
+/// Propagate the terminal size to the producer, once it stops changing       
+/// Dragging a window edge resizes the terminal many times in a row, and      
+/// renderers would otherwise reallocate their images for every step. The     
+/// deadline is checked on every update, in every mode, regardless of the     
+/// time steps it's given, or of whether the loop runs - once it passes, the  
+/// resize is queued with the input, and the loop is woken up to deliver it   
+///   @return true if a new size was propagated                               
+bool GUISystem::SettleSize() {
+   if (mTerminalSize.dimx == mSettledSize.dimx
+   and mTerminalSize.dimy == mSettledSize.dimy) {
+      mSettlingSize = mSettledSize;
       return false;
+   }
+
+   const auto now = Stamp();
+   if (mTerminalSize.dimx != mSettlingSize.dimx
+   or  mTerminalSize.dimy != mSettlingSize.dimy) {
+      // Changed again - wait for another full delay                    
+      mSettlingSize = mTerminalSize;
+      mSettleAt = now + Nanoseconds(mSettleDelay);
+      return false;
+   }
 
-   // Update all UI elements                                            
-   //for (auto& item : mItems)
-   //   item.Update(deltaTime);
+   if (now < mSettleAt)
+      return false;
 
-   // Yield FTXUI                                                       
-   mScreen.PostEvent(Event::Custom);
-   mLoop->RunOnce();
+   mSettledSize = mTerminalSize;
+   CatchResize(mSettledSize);
+   RequestRedraw();
    return true;
 }
 
+/// Resize the screen in memory, that headless systems render to, as if the   
+/// terminal was resized - the new size is reported once it settles           
+///   @param size - the new size, in cells                                    
+void GUISystem::ResizeOffscreen(const Scale2& size) {
+   const int width = ::std::max(static_cast<int>(size[0]), 1);
+   const int height = ::std::max(static_cast<int>(size[1]), 1);
+   if (width == mOffscreen.width() and height == mOffscreen.height())
+      return;
+
+   mOffscreen = Screen {width, height};
+   mTerminalSize = {width, height};
+
+   // Whatever was displayed at the old size is unknown                 
+   mEncoder.Invalidate();
+   mRedraw = true;
+}
+
+/// Tell the system that something besides the image changed, and FTXUI has   
+/// to render again - the editor and items call this when their state changes 
+void GUISystem::Invalidate() {
+   RequestRedraw();
+   mChanges.fetch_or(ChangedState, ::std::memory_order_acq_rel);
+}
+
+/// Ask FTXUI to redraw everything, which also picks up the latest frame      
+void GUISystem::RequestRedraw() {
+   if (mHeadless)
+      mRedraw = true;
+   else
+      mScreen.PostEvent(Event::Custom);
+}
+
+/// Special keys, in the order of InputEvent::Keys                            
+const Event* const SpecialKeys[] {
+   &Event::Return, &Event::Escape, &Event::Tab, &Event::TabReverse,
+   &Event::Backspace, &Event::Delete, &Event::Insert, &Event::Home,
+   &Event::End, &Event::PageUp, &Event::PageDown, &Event::ArrowUp,
+   &Event::ArrowDown, &Event::ArrowLeft, &Event::ArrowRight,
+   &Event::F1, &Event::F2, &Event::F3, &Event::F4, &Event::F5, &Event::F6,
+   &Event::F7, &Event::F8, &Event::F9, &Event::F10, &Event::F11, &Event::F12
+};
+
+/// Names of special keys, in the order of InputEvent::Keys                   
+constexpr Token KeyNames[] {
+   "Return", "Escape", "Tab", "TabReverse", "Backspace", "Delete", "Insert",
+   "Home", "End", "PageUp", "PageDown", "Up", "Down", "Left", "Right",
+   "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "F10", "F11", "F12"
+};
+
+/// Translate an FTXUI event                                                  
+///   @param event - the event                                                
+///   @param buttons - the mouse buttons held, to tell dragging from clicking 
+///   @param out - [out] the translated event                                 
+///   @return false if the event has no translation                           
+bool Translate(const Event& event, MouseButtons& buttons, InputEvent& out) {
+   if (event.is_mouse()) {
+      const auto& mouse = event.mouse();
+      out.mX = mouse.x;
+      out.mY = mouse.y;
+      out.mModifiers = (mouse.shift ? InputEvent::Shift : 0)
+         | (mouse.control ? InputEvent::Control : 0)
+         | (mouse.meta ? InputEvent::Meta : 0);
+
+      switch (mouse.button) {
+      case Mouse::WheelUp:
+      case Mouse::WheelDown:
+         out.mKind = InputEvent::Scroll;
+         out.mDelta = mouse.button == Mouse::WheelUp ? 1 : -1;
+         return true;
+      case Mouse::Left:
+      case Mouse::Middle:
+      case Mouse::Right:
+         buttons.Translate(
+            mouse.button == Mouse::Left ? InputEvent::ButtonLeft
+               : mouse.button == Mouse::Middle ? InputEvent::ButtonMiddle
+               : InputEvent::ButtonRight,
+            mouse.motion == Mouse::Pressed ? MouseButtons::Pressed
+               : mouse.motion == Mouse::Released ? MouseButtons::Released
+               : MouseButtons::Moved,
+            out);
+         return true;
+      case Mouse::None:
+         buttons.Move(out);
+         return true;
+      default:
+         return false;
+      }
+   }
+
+   if (event.is_character()) {
+      const auto& text = event.character();
+      if (text.size() >= sizeof(out.mText))
+         return false;
+      out.mKind = InputEvent::Character;
+      text.copy(out.mText, text.size());
+      out.mPressed = true;
+      return true;
+   }
+
+   for (uint8_t key = 0; key < ::std::size(SpecialKeys); ++key) {
+      if (event == *SpecialKeys[key]) {
+         out.mKind = InputEvent::Key;
+         out.mKey = key;
+         out.mPressed = true;
+         return true;
+      }
+   }
+   return false;
+}
+
+/// Collect an input event, caught by the loop, for the main thread           
+/// Events without a translation, like the custom ones that only wake the     
+/// loop up, are ignored                                                      
+///   @param event - the event                                                
+void GUISystem::CatchInput(const Event& event) {
+   if (event == Event::Custom)
+      return;
+
+   InputEvent input;
+   if (Translate(event, mMouseButtons, input))
+      mInputBatch.Push(input);
+
+   // Events arrive in bursts, and the rest of a burst might already be 
+   // queued in the loop, where polling the terminal can't see it       
+   mChanges.fetch_or(ChangedInput, ::std::memory_order_acq_rel);
+}
+
+/// Collect a terminal resize, for the main thread                            
+///   @param size - the new terminal size                                     
+void GUISystem::CatchResize(const Dimensions& size) {
+   InputEvent input;
+   input.mKind = InputEvent::Resize;
+   input.mX = size.dimx;
+   input.mY = size.dimy;
+   mInputBatch.Push(input);
+}
+
+/// Convert an input event to a Langulus event                                
+///   @param input - the input event                                          
+///   @return the Langulus event                                              
+Langulus::Event ToEvent(const InputEvent& input) {
+   Langulus::Event event;
+   event.mState = input.mPressed ? EventState::Begin : EventState::End;
+   switch (input.mKind) {
+   case InputEvent::Key:
+      event.mType = MetaOf<Events::Key>();
+      event.mPayload << Text {KeyNames[input.mKey]};
+      break;
+   case InputEvent::Character:
+      event.mType = MetaOf<Events::Key>();
+      event.mPayload << Text {Token {input.mText}};
+      break;
+   case InputEvent::MouseMove:
+      event.mType = MetaOf<Events::MouseMove>();
+      event.mState = EventState::Point;
+      event.mPayload << Vec2i {input.mX, input.mY} << static_cast<Count>(input.mButtons);
+      break;
+   case InputEvent::MouseButton:
+      event.mType = MetaOf<Events::MouseButton>();
+      event.mPayload << Vec2i {input.mX, input.mY} << static_cast<Count>(input.mButton);
+      break;
+   case InputEvent::Scroll:
+      event.mType = MetaOf<Events::MouseScroll>();
+      event.mState = EventState::Point;
+      event.mPayload << Vec2i {input.mX, input.mY} << Vec2i {0, input.mDelta};
+      break;
+   case InputEvent::Resize:
+      event.mType = MetaOf<Events::WindowResize>();
+      event.mState = EventState::Point;
+      event.mPayload << Scale2 {input.mX, input.mY};
+      break;
+   }
+
+   if (input.mModifiers)
+      event.mPayload << static_cast<Count>(input.mModifiers);
+   return event;
+}
+
+/// Deliver the batch of input events to the hierarchy, as a single interact  
+/// verb, instead of one dispatch per raw event                               
+void GUISystem::Dispatch() {
+   TMany<Langulus::Event> events;
+   events.Reserve(mInput.size());
+   for (auto& input : mInput)
+      events << ToEvent(input);
+
+   Verbs::Interact interact {::std::move(events)};
+   for (auto& owner : GetOwners())
+      owner->Run(interact);
+}
+
+/// Get the input statistics - how many events were caught, and how many of   
+/// them were coalesced, before being dispatched                              
+///   @return the statistics                                                  
+auto GUISystem::GetInputStats() const -> InputBatch::Stats {
+   return mInputBatch.GetStats();
+}
+
+/// Get the rolling statistics of recent frames                               
+/// Histograms can be read from any thread, while frames are recorded         
+///   @return the statistics                                                  
+auto GUISystem::GetStats() const noexcept -> const FrameStats& {
+   return mStats;
+}
+
+/// Summarize a histogram as its median, 99th percentile, and maximum         
+///   @param histogram - the histogram to summarize                           
+///   @return the summary                                                     
+TMany<uint64_t> Summarize(const Histogram& histogram) {
+   const auto snapshot = histogram.GetSnapshot();
+   TMany<uint64_t> summary;
+   summary << snapshot.Percentile(50) << snapshot.Percentile(99) << snapshot.mMax;
+   return summary;
+}
+
+/// Answer queries for frame statistics, for the output of headless systems,  
+/// and for searches of the hierarchy the editor shows                        
+///   @param verb - the selection verb, containing the traits to answer       
+void GUISystem::Select(Verb& verb) {
+   verb.ForEachDeep([&](const TMeta& trait) {
+      if (trait->Is<Traits::ConvertTime>())
+         verb << Traits::ConvertTime {Summarize(mStats.mConvert)};
+      else if (trait->Is<Traits::LayoutTime>())
+         verb << Traits::LayoutTime {Summarize(mStats.mLayout)};
+      else if (trait->Is<Traits::WriteTime>())
+         verb << Traits::WriteTime {Summarize(mStats.mWrite)};
+      else if (trait->Is<Traits::CellsChanged>())
+         verb << Traits::CellsChanged {Summarize(mStats.mCells)};
+      else if (trait->Is<Traits::BytesEmitted>())
+         verb << Traits::BytesEmitted {Summarize(mStats.mBytes)};
+      else if (trait->Is<Traits::InputEvents>())
+         verb << Traits::InputEvents {Summarize(mStats.mInput)};
+      else if (trait->Is<Traits::DroppedFrames>())
+         verb << Traits::DroppedFrames {mDroppedFrames};
+      else if (trait->Is<Traits::Display>())
+         verb << Traits::Display {Text {Token {GetOutput()}}};
+      else if (trait->Is<Traits::Size>()) {
+         // Images of this size fill the terminal, once it settles      
+         verb << Traits::Size {GetSize()};
+      }
+      else if (trait->Is<Traits::CellFormat>()) {
+         // Frames of this size can be associated natively              
+         verb << Traits::CellFormat {GetTerminalSize()};
+      }
+   });
+
+   // Searches carry their query                                        
+   if (not mEditor)
+      return;
+
+   verb.ForEachDeep([&](const Trait& trait) {
+      if (trait.template IsTrait<Traits::Search>()) {
+         const auto query = trait.template As<Text>();
+         verb << Traits::Search {mEditor->Find(Token {query})};
+      }
+   });
+}
+
 /// React on environmental change                                             
 void GUISystem::Refresh() {
 
 }
 
+/// Convert a packed color to an FTXUI color                                  
+///   @param c - the packed color                                             
+///   @return the FTXUI color                                                 
+Color ToColor(Kernels::RGB8 c) noexcept {
+   switch (Kernels::PaletteOf(c)) {
+   case Kernels::Indexed256:
+      return Color {static_cast<Color::Palette256>(Kernels::Index(c))};
+   case Kernels::Indexed16:
+      return Color {static_cast<Color::Palette16>(Kernels::Index(c))};
+   default:
+      return Color {Kernels::Red(c), Kernels::Green(c), Kernels::Blue(c)};
+   }
+}
+
+/// Pick up the latest drawn frame, and convert the rows that changed since   
+/// the previously emitted frame to FTXUI pixels                              
+/// This is the only place where cells are expanded to ftxui::Pixel           
+void GUISystem::Emit() {
+   LANGULUS(PROFILE);
+   ::std::scoped_lock lock {mGlyphsMutex};
+   mFrames.Acquire();
+   const auto& frame = mFrames.GetFront();
+   const auto& cells = frame.mCells;
+   if (static_cast<int>(cells.mWidth)  != mOutput->mImage.width()
+   or  static_cast<int>(cells.mHeight) != mOutput->mImage.height()
+   or  cells.mHeight != mOutput->mHashes.size()) {
+      if (not cells.GetCount())
+         return;
+      mOutput = &AcquireOutput(cells.mWidth, cells.mHeight);
+   }
+
+   mOutput->mLastUse = ++mOutputUses;
+   auto& hashes = mOutput->mHashes;
+   auto& pixels = mOutput->mImage.get_pixels();
+   for (uint32_t y = 0; y < cells.mHeight; ++y) {
+      // Rows converted from the same image row are the same            
+      if (frame.mRowHashes[y] == hashes[y])
+         continue;
+      hashes[y] = frame.mRowHashes[y];
+
+      const auto offset = cells.RowOffset(y);
+      auto p = pixels.data() + offset;
+      for (auto i = offset; i < offset + cells.mWidth; ++i, ++p) {
+         p->style.background_color = ToColor(cells.mBg[i]);
+         p->style.foreground_color = ToColor(cells.mFg[i]);
+
+         const auto style = cells.mStyles[i];
+         p->style.bold = style & CellBold;
+         p->style.dim = style & CellDim;
+         p->style.italic = style & CellItalic;
+         p->style.underlined = style & CellUnderlined;
+         p->style.underlined_double = style & CellUnderlinedDouble;
+         p->style.blink = style & CellBlink;
+         p->style.inverted = style & CellInverted;
+         p->style.strikethrough = style & CellStrikethrough;
+         p->style.automerge = false;
+
+         // Assigning reuses the pixel's string capacity                
+         p->grapheme = mGlyphs.Get(cells.mGlyphs[i]);
+      }
+   }
+
+   // FTXUI is about to redraw the whole terminal with these cells, or  
+   // with these cells and the items over them, which the encoder can't 
+   // know about                                                        
+   if (mDirectOutput.load(::std::memory_order_acquire))
+      mEncoder.Sync(cells);
+   else
+      mEncoder.Invalidate();
+}
+
+/// Get an image to display frames of the given size                          
+/// Recently displayed images are pooled - only if none of them has the size, 
+/// the least recently displayed one is reallocated                           
+///   @param width - width of the image, in cells                             
+///   @param height - height of the image, in cells                           
+///   @return the image                                                       
+auto GUISystem::AcquireOutput(uint32_t width, uint32_t height) -> Output& {
+   auto oldest = mOutputs;
+   for (auto& output : mOutputs) {
+      if (output.mImage.width() == static_cast<int>(width)
+      and output.mImage.height() == static_cast<int>(height)
+      and output.mHashes.size() == height)
+         return output;
+      if (output.mLastUse < oldest->mLastUse)
+         oldest = &output;
+   }
+
+   VERBOSE_GUI("Allocating output image of ", width, "x", height);
+   oldest->mImage = Image {static_cast<int>(width), static_cast<int>(height)};
+   oldest->mHashes.assign(height, 0);
+   return *oldest;
+}
+
+/// Present the latest drawn frame, if there's one                            
+/// When only the image is displayed, changed cells are encoded and written   
+/// straight to the terminal. Otherwise, or when the encoder can't produce a  
+/// difference, FTXUI is asked to redraw everything                           
+void GUISystem::Present() {
+   LANGULUS(PROFILE);
+   mWakePending.store(false, ::std::memory_order_release);
+   if (not mFrames.HasFresh())
+      return;
+
+   if (not mDirectOutput.load(::std::memory_order_acquire)) {
+      RequestRedraw();
+      return;
+   }
+
+   ::std::scoped_lock lock {mGlyphsMutex};
+   mFrames.Acquire();
+   const auto& cells = mFrames.GetFront().mCells;
+   if (not mEncoder.CanDiff(cells)) {
+      // Emit synchronizes the encoder, when FTXUI redraws              
+      RequestRedraw();
+      return;
+   }
+
+   const auto start = Stamp();
+   const auto size = GetTerminalSize();
+   mEncoder.Encode(cells, mGlyphs,
+      static_cast<uint32_t>(size[0]),
+      static_cast<uint32_t>(size[1]), mEncoded);
+
+   if (not mHeadless and not mEncoded.empty()) {
+      // FTXUI writes to the same stream                                
+      ::std::cout.write(mEncoded.data(), mEncoded.size());
+      ::std::cout.flush();
+   }
+
+   mStats.mWrite.Record(Stamp() - start);
+   mStats.mBytes.Record(mEncoded.size());
+}
+
 /// Get console window's handle                                               
 ///   @return the handle                                                      
 void* GUISystem::GetNativeHandle() const noexcept {
@@ -98,10 +848,85 @@ void* GUISystem::GetNativeHandle() const noexcept {
 
 /// Get the console window size, in characters                                
 ///   @return the size of the console window, in characters                   
-auto GUISystem::GetSize() const noexcept -> Scale2 {
+auto GUISystem::GetTerminalSize() const noexcept -> Scale2 {
+   if (mHeadless)
+      return {mOffscreen.width(), mOffscreen.height()};
    return {mScreen.width(), mScreen.height()};
 }
 
+/// Get the resolution images should be drawn at, to fill the console window  
+/// When color-only images are drawn as half blocks, each character holds     
+/// two pixels, one above the other                                           
+///   @return the resolution, in pixels                                       
+auto GUISystem::GetSize() const noexcept -> Scale2 {
+   // Resizes are reported only once the terminal settles on a size     
+   Scale2 size {mSettledSize.dimx, mSettledSize.dimy};
+   if (mHalfBlocks)
+      size[1] *= 2;
+   return size;
+}
+
+/// Get the cells of the last presented frame                                 
+/// Not thread-safe in threaded mode - meant for headless mode, where         
+/// frames are presented on Update                                            
+///   @return the cells, glyphs refer to GetGlyphs()                          
+auto GUISystem::GetCells() const noexcept -> const CellBuffer& {
+   return mFrames.GetFront().mCells;
+}
+
+/// Get the table of graphemes that cells refer to                            
+///   @return the grapheme table                                              
+auto GUISystem::GetGlyphs() const noexcept -> const GlyphTable& {
+   return mGlyphs;
+}
+
+/// Get the bytes written to the terminal by the last presented frame         
+/// In headless mode these are produced on Update, but never written          
+/// anywhere. Full redraws are included only in headless mode, and are        
+/// turned to text here, so that updates nobody inspects don't allocate       
+///   @return the escape sequences and graphemes                              
+auto GUISystem::GetOutput() const -> const ::std::string& {
+   if (mOffscreenDirty) {
+      mOffscreenDirty = false;
+      mEncoded = mOffscreen.ToString();
+   }
+   return mEncoded;
+}
+
+/// Get the screen the component tree is rendered to in headless mode         
+///   @return the offscreen screen                                            
+auto GUISystem::GetOffscreen() const noexcept -> const Screen& {
+   return mOffscreen;
+}
+
+/// Get the number of cells that were converted during the last Draw call     
+/// Cells in rows that didn't change since the previous frame aren't counted  
+///   @return the number of touched cells                                     
+auto GUISystem::GetTouchedCells() const noexcept -> Count {
+   return mTouchedCells;
+}
+
+/// Get the number of frames that were drawn, but replaced by a newer frame   
+/// before the FTXUI loop got to them                                         
+///   @return the number of dropped frames                                    
+auto GUISystem::GetDroppedFrames() const noexcept -> Count {
+   return mDroppedFrames;
+}
+
+/// Get the number of updates, in which the loop didn't run at all, because   
+/// nothing changed                                                           
+///   @return the number of idle updates                                      
+auto GUISystem::GetIdleUpdates() const noexcept -> Count {
+   return mIdleUpdates;
+}
+
+/// Get statistics about the bytes written to the terminal by the encoder     
+/// Full redraws made by FTXUI aren't included                                
+///   @return the statistics                                                  
+auto GUISystem::GetOutputStats() const noexcept -> const Encoder::Stats& {
+   return mEncoder.GetStats();
+}
+
 /// Check if console window is minimized                                      
 ///   @return always false                                                    
 bool GUISystem::IsMinimized() const noexcept {
@@ -109,120 +934,644 @@ bool GUISystem::IsMinimized() const noexcept {
    return false;
 }
 
+/// Get a typed view of an image channel, without any type checks             
+/// Only use on channels that were already probed by DetectLayout             
+///   @param channel - the channel to view                                    
+///   @param cells - number of cells the channel must have                    
+///   @return the raw channel data, or nullptr if channel is too small        
+template<class T>
+const T* RawChannel(const Many& channel, Count cells) noexcept {
+   const auto& typed = channel.template Get<TMany<T>>();
+   return typed.GetCount() >= cells ? typed.GetRaw() : nullptr;
+}
+
+/// Check if an image channel contains a given type                           
+///   @param channel - the channel to probe                                   
+///   @return true if channel can be interpreted as TMany<T>                  
+template<class T>
+bool ProbeChannel(const Many& channel) noexcept {
+   try {
+      (void) channel.template As<TMany<T>>();
+      return true;
+   }
+   catch (...) {
+      return false;
+   }
+}
+
+/// Get the format of an image's channels                                     
+/// Comparing formats is cheap, and doesn't involve any reflection lookups    
+///   @param image - the image to inspect                                     
+///   @return the format                                                      
+auto GUISystem::ImageFormat::From(const A::Image& image) -> ImageFormat {
+   ImageFormat result;
+   const auto colorData = image.GetDataList<Traits::Color>();
+   if (colorData) {
+      const auto count = ::std::min(colorData->GetCount(), Count {2});
+      for (Offset i = 0; i < count; ++i)
+         result.mColors[i] = (*colorData)[i].GetType();
+   }
+
+   const auto additionalData = image.GetDataList();
+   if (additionalData) {
+      const auto count = ::std::min(additionalData->GetCount(), Count {2});
+      for (Offset i = 0; i < count; ++i)
+         result.mData[i] = (*additionalData)[i].GetType();
+   }
+   return result;
+}
+
+/// Probe the channels of an image, to find out how to interpret them         
+/// This involves reflection and exceptions, so it is done only when the      
+/// format of the drawn images changes                                        
+///   @param image - the image to probe                                       
+///   @return the detected layout                                             
+auto GUISystem::DetectLayout(const A::Image& image) -> Layout {
+   using RGBA = Math::RGBAf;
+   const auto colorData = image.GetDataList<Traits::Color>();
+   const auto colors = colorData ? colorData->GetCount() : 0;
+   if (colors == 0 or not ProbeChannel<RGBA>((*colorData)[0]))
+      return Layout::Unsupported;
+   if (colors == 1)
+      return Layout::Background;
+   if (not ProbeChannel<RGBA>((*colorData)[1]))
+      return Layout::Background;
+
+   const auto additionalData = image.GetDataList();
+   const auto extra = additionalData ? additionalData->GetCount() : 0;
+   if (extra == 0 or not ProbeChannel<::std::string_view>((*additionalData)[0]))
+      return Layout::Colors;
+   if (extra == 1 or not ProbeChannel<Logger::Emphasis>((*additionalData)[1]))
+      return Layout::Symbols;
+   return Layout::Styles;
+}
+
+/// Get the conversion pipeline, specialized for a layout                     
+///   @param layout - the layout                                              
+///   @return the pipeline, or nullptr if layout is unsupported               
+auto GUISystem::GetPipeline(Layout layout) noexcept -> Pipeline {
+   switch (layout) {
+   case Layout::Background:
+      return &GUISystem::DrawPipeline<Layout::Background>;
+   case Layout::HalfBlocks:
+      return &GUISystem::DrawPipeline<Layout::HalfBlocks>;
+   case Layout::Colors:
+      return &GUISystem::DrawPipeline<Layout::Colors>;
+   case Layout::Symbols:
+      return &GUISystem::DrawPipeline<Layout::Symbols>;
+   case Layout::Styles:
+      return &GUISystem::DrawPipeline<Layout::Styles>;
+   default:
+      return nullptr;
+   }
+}
+
 /// Draw an image, interpreting it as console output                          
 ///   @param what - the image to interpret to console output                  
 ///   @return true if interpretation was a success                            
 bool GUISystem::Draw(const Langulus::Ref<A::Image>& what) const {
    LANGULUS(PROFILE);
    const auto& image = const_cast<const A::Image&>(*what);
-   auto colorData = image.GetDataList<Traits::Color>();
-   auto additionalData = image.GetDataList();
-   using RGB = Math::RGB;
-   using Style = Logger::Emphasis;
-
-   if (image.GetView().mWidth  != mBackbuffer.width()
-   or  image.GetView().mHeight != mBackbuffer.height()) {
-      mBackbuffer = Image {
-         static_cast<int>(image.GetView().mWidth ),
-         static_cast<int>(image.GetView().mHeight)
-      };
-   }
-
-   if (colorData and *colorData and additionalData and *additionalData) {
-      try {
-         // A fully fledged ASCII image                                 
-         // First color container is the foreground color array         
-         //const auto& fgColor = (*colorData)[0].As<TMany<Math::RGBAf>>();
-         //auto fgColor_raw = fgColor.GetRaw();
-
-         // Second color container is the background color array        
-         const auto& bgColor = (*colorData)[1].As<TMany<Math::RGBAf>>();
-         auto bgColor_raw = bgColor.GetRaw();
-
-         // Character data per pixel                                    
-         const auto& symbols = (*additionalData)[0].As<TMany<::std::string_view>>();
-         auto symbols_raw = symbols.GetRaw();
-
-         // VT100 emphasis per pixel                                    
-         //const auto& styles  = (*additionalData)[1].As<TMany<Style>>();
-         //auto styles_raw = styles.GetRaw();
-
-         // Build an ftxui::Image                                       
-         auto p = mBackbuffer.get_pixels().data();
-         for (uint32_t y = 0; y < image.GetView().mHeight; ++y) {
-            for (uint32_t x = 0; x < image.GetView().mWidth; ++x) {
-               p->style.background_color = Color {
-                  static_cast<uint8_t>(bgColor_raw->r * 255),
-                  static_cast<uint8_t>(bgColor_raw->g * 255),
-                  static_cast<uint8_t>(bgColor_raw->b * 255)
-               };
-
-               auto fg = static_cast<uint8_t>(255 - (bgColor_raw->r * 0.299 + bgColor_raw->g * 0.587 + bgColor_raw->b * 0.114) * 255);
-               if (fg >= 100 and fg <= 156) fg -= 100;
-               p->style.foreground_color = Color {fg, fg, fg};
-
-               p->grapheme = *symbols_raw;
-               //p->style.background_color = Color {static_cast<uint8_t>(bgColor_raw->r * 255), 0, 0};
-               //p->style.foreground_color = Color {static_cast<uint8_t>(fgColor_raw->r * 255), static_cast<uint8_t>(fgColor_raw->g * 255), static_cast<uint8_t>(fgColor_raw->b * 255)};
-
-               /*auto& style = *styles_raw;
-               p->style.blink = style & Style::Blink;
-               p->style.bold = style & Style::Bold;
-               p->style.dim = style & Style::Faint;
-               p->style.italic = style & Style::Italic;
-               p->style.inverted = style & Style::Reverse;
-               p->style.underlined = style & Style::Underline;
-               p->style.underlined_double = false;
-               p->style.strikethrough = style & Style::Strike;
-               p->style.automerge = false;*/
-
-               //++fgColor_raw;
-               ++bgColor_raw;
-               ++symbols_raw;
-               //++ps;
-               ++p;
-               //++styles_raw;
-            }
+   const auto width  = image.GetView().mWidth;
+   const auto height = image.GetView().mHeight;
+   mTouchedCells = 0;
+
+   // Layout is detected only when the format of the image changes,     
+   // consecutive frames go straight to the specialized pipeline        
+   const auto format = ImageFormat::From(image);
+   if (format != mFormat) {
+      mFormat = format;
+      mLayout = DetectLayout(image);
+      if (mLayout == Layout::Background and mHalfBlocks)
+         mLayout = Layout::HalfBlocks;
+      mPipeline = GetPipeline(mLayout);
+      VERBOSE_GUI("Image layout changed to ", static_cast<int>(mLayout));
+   }
+
+   if (not mPipeline)
+      return false;
+
+   // Gather the raw channels - they are already probed                 
+   using RGBA = Math::RGBAf;
+   const Count cells = Count {width} * height;
+   const auto colorData = image.GetDataList<Traits::Color>();
+   const auto additionalData = image.GetDataList();
+   Channels channels {};
+   channels.mHeight = height;
+   switch (mLayout) {
+   case Layout::Styles:
+      channels.mStyles = RawChannel<Logger::Emphasis>((*additionalData)[1], cells);
+      if (not channels.mStyles)
+         return false;
+      [[fallthrough]];
+   case Layout::Symbols:
+      channels.mSymbols = RawChannel<::std::string_view>((*additionalData)[0], cells);
+      if (not channels.mSymbols)
+         return false;
+      [[fallthrough]];
+   case Layout::Colors:
+      // First color container is the foreground color array            
+      // Second color container is the background color array           
+      channels.mFg = RawChannel<RGBA>((*colorData)[0], cells);
+      channels.mBg = RawChannel<RGBA>((*colorData)[1], cells);
+      break;
+   default:
+      channels.mBg = RawChannel<RGBA>((*colorData)[0], cells);
+      break;
+   }
+
+   if (not channels.mBg)
+      return false;
+
+   DrawChannels(width, channels);
+   return true;
+}
+
+/// Convert gathered channels to cells with the current pipeline, and publish 
+/// the frame                                                                 
+///   @param width - width of the channels, in pixels                         
+///   @param channels - the channels, gathered according to the layout        
+void GUISystem::DrawChannels(uint32_t width, const Channels& channels) const {
+   // Half blocks pack two rows of pixels in each row of cells          
+   const auto height = channels.mHeight;
+   const auto rows = mLayout == Layout::HalfBlocks ? (height + 1) / 2 : height;
+   ReserveGlyphs(Count {width} * rows);
+   auto& frame = mFrames.GetBack();
+   if (width != frame.mCells.mWidth or rows != frame.mCells.mHeight) {
+      frame.mCells.Resize(width, rows);
+
+      // Nothing in this buffer can be reused after a resize            
+      frame.mRowHashes.assign(rows, 0);
+   }
+
+   const auto start = Stamp();
+   (this->*mPipeline)(frame, channels);
+   mStats.mConvert.Record(Stamp() - start);
+   mStats.mCells.Record(mTouchedCells);
+   PublishFrame();
+}
+
+/// Make room for all graphemes of a frame, by recycling the glyph table,     
+/// if it might run out of it - graphemes in all frames are kept, so frames   
+/// show the same, and their row hashes remain valid                          
+///   @param cells - number of cells that are about to be drawn               
+void GUISystem::ReserveGlyphs(Count cells) const {
+   // Huge frames reserve only a part of the table, and the table is    
+   // recycled only once that much was interned since the last time,    
+   // so that a table full of graphemes in use isn't recycled each frame
+   const auto room = static_cast<uint32_t>(
+      ::std::min<Count>(cells, GlyphTable::Capacity / 4));
+   const auto count = mGlyphs.GetCount();
+   if (count + room <= GlyphTable::Capacity or count < mGlyphsKept + room)
+      return;
+
+   // The loop might be reading frames on its own thread                
+   ::std::scoped_lock lock {mGlyphsMutex};
+   CellBuffer* frames[] {
+      &mFrames.GetBuffer(0).mCells,
+      &mFrames.GetBuffer(1).mCells,
+      &mFrames.GetBuffer(2).mCells
+   };
+   const auto dropped = mGlyphs.Recycle(frames);
+   mHalfBlock = mGlyphs.Intern("▀");
+   mGlyphsKept = mGlyphs.GetCount();
+
+   // The encoder's copy of the terminal has the old identifiers        
+   mEncoder.Invalidate();
+   VERBOSE_GUI("Recycled ", dropped, " graphemes");
+}
+
+/// Seeds for hashing rows of cells, that were drawn without an image - they  
+/// never match the seed of a layout, so a later Draw converts those rows     
+constexpr uint64_t AssociatedSeed = 0xA550C1A7EDull;
+constexpr uint64_t CommittedSeed = 0xC0441778EDull;
+
+/// Hash a single row of cells, drawn in the native layout                    
+///   @param seed - anything else that affects how the row is drawn           
+///   @param bg - the packed background colors of the row                     
+///   @param fg - the packed foreground colors of the row, can be nullptr     
+///   @param glyphs - the glyphs of the row, can be nullptr                   
+///   @param styles - the style bits of the row, can be nullptr               
+///   @param width - number of cells in the row                               
+///   @return the hash, never zero, because zero marks an invalid row         
+template<class GLYPH>
+uint64_t HashCells(
+   uint64_t seed, const Kernels::RGB8* bg, const Kernels::RGB8* fg,
+   const GLYPH* glyphs, const uint8_t* styles, uint32_t width
+) noexcept {
+   // Missing channels are filled in, so they have to change the hash   
+   const uint64_t present = (fg ? 1 : 0) | (glyphs ? 2 : 0) | (styles ? 4 : 0);
+   auto h = HashMix(HashMix(HashMix(seed, width), present),
+      bg, sizeof(Kernels::RGB8) * width);
+   if (fg)
+      h = HashMix(h, fg, sizeof(Kernels::RGB8) * width);
+   if (glyphs)
+      h = HashMix(h, glyphs, sizeof(GLYPH) * width);
+   if (styles)
+      h = HashMix(h, styles, width);
+   return h ? h : 1;
+}
+
+/// Encode a code point in UTF-8                                              
+/// Surrogates and anything beyond the last code point aren't characters,     
+/// and become the replacement character instead                              
+///   @param codepoint - the code point                                       
+///   @param out - [out] up to four bytes                                     
+///   @return the number of bytes                                             
+uint32_t EncodeUTF8(uint32_t codepoint, char* out) noexcept {
+   if ((codepoint >= 0xD800 and codepoint <= 0xDFFF) or codepoint > 0x10FFFF)
+      codepoint = 0xFFFD;
+
+   if (codepoint < 0x80) {
+      out[0] = static_cast<char>(codepoint);
+      return 1;
+   }
+   if (codepoint < 0x800) {
+      out[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+      out[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+      return 2;
+   }
+   if (codepoint < 0x10000) {
+      out[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+      out[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+      out[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+      return 3;
+   }
+   out[0] = static_cast<char>(0xF0 | ((codepoint >> 18) & 0x07));
+   out[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+   out[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+   out[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+   return 4;
+}
+
+/// Draw cells handed over through reflection, so that renderer modules can   
+/// draw in the native format, without including anything from this module    
+/// Packed colors, code points, and style bits are copied as they are, and    
+/// only code points beyond ASCII are interned. Rows that are already in the  
+/// backbuffer aren't copied at all, and aren't presented again. RGBA float   
+/// colors are converted instead, exactly like the color channels of an       
+/// image, in which case glyphs and styles are ignored. A search reveals its  
+/// first match in the editor's tree instead                                  
+///   @param verb - the association verb, with the size and the channels      
+void GUISystem::Associate(Verb& verb) {
+   const Trait* size {};
+   const Trait* glyphs {};
+   const Trait* fg {};
+   const Trait* bg {};
+   const Trait* styles {};
+   verb.ForEachDeep([&](const Trait& trait) {
+      if (trait.template IsTrait<Traits::Search>()) {
+         if (mEditor) {
+            mEditor->Reveal(Token {trait.template As<Text>()});
+            verb.Done();
          }
+      }
+      else if (trait.template IsTrait<Traits::Size>())
+         size = &trait;
+      else if (trait.template IsTrait<Traits::CellGlyphs>())
+         glyphs = &trait;
+      else if (trait.template IsTrait<Traits::CellForeground>())
+         fg = &trait;
+      else if (trait.template IsTrait<Traits::CellBackground>())
+         bg = &trait;
+      else if (trait.template IsTrait<Traits::CellStyles>())
+         styles = &trait;
+   });
 
-         return true;
+   if (size and not glyphs and not fg and not bg and not styles) {
+      // Only a size - headless systems pretend the terminal resized    
+      if (mHeadless)
+         ResizeOffscreen(size->template As<Scale2>());
+      return;
+   }
+
+   if (not size or not bg)
+      return;
+
+   const auto extent = size->template As<Scale2>();
+   const auto width = static_cast<uint32_t>(::std::max(extent[0], decltype(extent[0]) {}));
+   const auto height = static_cast<uint32_t>(::std::max(extent[1], decltype(extent[1]) {}));
+   const Count count = Count {width} * height;
+   if (not count)
+      return;
+
+   using RGBA = Math::RGBAf;
+   if (ProbeChannel<RGBA>(*bg)) {
+      // Same as drawing an image with these color channels - the next  
+      // drawn image has its format probed again                        
+      Channels channels {};
+      channels.mHeight = height;
+      channels.mBg = RawChannel<RGBA>(*bg, count);
+      if (fg and ProbeChannel<RGBA>(*fg))
+         channels.mFg = RawChannel<RGBA>(*fg, count);
+      if (not channels.mBg)
+         return;
+
+      mFormat = {};
+      mLayout = channels.mFg ? Layout::Colors
+         : mHalfBlocks ? Layout::HalfBlocks : Layout::Background;
+      mPipeline = GetPipeline(mLayout);
+      mTouchedCells = 0;
+      DrawChannels(width, channels);
+      verb.Done();
+      return;
+   }
+
+   if (not ProbeChannel<Kernels::RGB8>(*bg))
+      return;
+   const auto bgs = RawChannel<Kernels::RGB8>(*bg, count);
+   const auto fgs = fg and ProbeChannel<Kernels::RGB8>(*fg)
+      ? RawChannel<Kernels::RGB8>(*fg, count) : nullptr;
+   const auto codepoints = glyphs and ProbeChannel<uint32_t>(*glyphs)
+      ? RawChannel<uint32_t>(*glyphs, count) : nullptr;
+   const auto bits = styles and ProbeChannel<uint8_t>(*styles)
+      ? RawChannel<uint8_t>(*styles, count) : nullptr;
+   if (not bgs)
+      return;
+
+   auto& cells = AcquireCells(width, height);
+   auto& frame = mFrames.GetBack();
+   mTouchedCells = 0;
+   for (uint32_t y = 0; y < height; ++y) {
+      // Skip rows that are already in this frame - it might be a few   
+      // frames old, but those rows haven't changed since               
+      const auto offset = cells.RowOffset(y);
+      const auto hash = HashCells(AssociatedSeed, bgs + offset,
+         fgs ? fgs + offset : nullptr,
+         codepoints ? codepoints + offset : nullptr,
+         bits ? bits + offset : nullptr, width);
+      if (hash == frame.mRowHashes[y])
+         continue;
+
+      frame.mRowHashes[y] = hash;
+      mTouchedCells += width;
+
+      ::std::copy_n(bgs + offset, width, cells.mBg.data() + offset);
+      if (fgs)
+         ::std::copy_n(fgs + offset, width, cells.mFg.data() + offset);
+      else
+         ::std::fill_n(cells.mFg.data() + offset, width, Kernels::Pack(255, 255, 255));
+      if (bits)
+         ::std::copy_n(bits + offset, width, cells.mStyles.data() + offset);
+      else
+         ::std::fill_n(cells.mStyles.data() + offset, width, uint8_t {});
+
+      if (not codepoints) {
+         ::std::fill_n(cells.mGlyphs.data() + offset, width, GlyphTable::Space);
+         continue;
+      }
+
+      for (auto i = offset; i < offset + width; ++i) {
+         const auto codepoint = codepoints[i];
+         if (codepoint < 0x80) {
+            // ASCII, and the empty continuation of wide graphemes,     
+            // are their own identifiers                                
+            cells.mGlyphs[i] = static_cast<GlyphID>(codepoint);
+            continue;
+         }
+
+         char utf8[4];
+         cells.mGlyphs[i] = mGlyphs.Intern({utf8, EncodeUTF8(codepoint, utf8)});
       }
-      catch (...) {}
    }
-   
-   /*if (colorData and *colorData) {
-      try {
+
+   mStats.mCells.Record(mTouchedCells);
+   PublishFrame();
+   verb.Done();
+}
+
+/// Acquire the backbuffer, to draw cells into it directly, instead of        
+/// drawing an image that has to be converted - glyphs are identifiers from   
+/// InternGlyph, colors are packed, and styles are CellStyle bits             
+/// The buffer holds a frame that is a few frames old, so every cell has to   
+/// be written. Call CommitCells when done, from the same thread as Draw      
+///   @param width - width of the frame, in cells                             
+///   @param height - height of the frame, in cells                           
+///   @return the cells to draw to                                            
+auto GUISystem::AcquireCells(uint32_t width, uint32_t height) -> CellBuffer& {
+   ReserveGlyphs(Count {width} * height);
+   auto& frame = mFrames.GetBack();
+   if (width != frame.mCells.mWidth or height != frame.mCells.mHeight) {
+      frame.mCells.Resize(width, height);
+      frame.mRowHashes.assign(height, 0);
+   }
+   return frame.mCells;
+}
+
+/// Get the identifier of a grapheme, for drawing into acquired cells         
+/// ASCII characters are their own identifiers, and never need interning      
+/// Other identifiers are valid only until the next AcquireCells, which       
+/// might recycle them                                                        
+///   @param glyph - the grapheme                                             
+///   @return the identifier                                                  
+auto GUISystem::InternGlyph(::std::string_view glyph) -> GlyphID {
+   return mGlyphs.Intern(glyph);
+}
+
+/// Publish the cells drawn into the acquired backbuffer                      
+/// Nothing is converted or copied - the buffer is swapped with the others,   
+/// and only rows that differ from what was last drawn in it are presented    
+void GUISystem::CommitCells() {
+   auto& frame = mFrames.GetBack();
+   const auto& cells = frame.mCells;
+   mTouchedCells = 0;
+   for (uint32_t y = 0; y < cells.mHeight; ++y) {
+      const auto offset = cells.RowOffset(y);
+      const auto hash = HashCells(CommittedSeed, cells.mBg.data() + offset,
+         cells.mFg.data() + offset, cells.mGlyphs.data() + offset,
+         cells.mStyles.data() + offset, cells.mWidth);
+      if (hash == frame.mRowHashes[y])
+         continue;
+
+      frame.mRowHashes[y] = hash;
+      mTouchedCells += cells.mWidth;
+   }
+
+   mStats.mCells.Record(mTouchedCells);
+   PublishFrame();
+}
+
+/// Publish the backbuffer as the latest frame, and make sure it's presented  
+void GUISystem::PublishFrame() const {
+   if (mFrames.Publish())
+      ++mDroppedFrames;
+
+   // In threaded mode, the loop waits for new frames on its own        
+   // thread - wake it up, unless a wake-up is already pending. A       
+   // closure doesn't invalidate the FTXUI frame, unlike an event       
+   if (mThreaded and not mWakePending.exchange(true, ::std::memory_order_acq_rel))
+      mScreen.Post(Closure([this] { Present(); }));
+}
+
+/// Convert an ASCII image to the backbuffer                                  
+/// Large images are split into bands of rows, that are converted in          
+/// parallel, on the thread pool of the producer                              
+///   @tparam LAYOUT - the layout of the image, resolved at compile time      
+///   @param frame - the frame to draw to, sized as the image                 
+///   @param channels - the raw image channels                                
+template<GUISystem::Layout LAYOUT>
+void GUISystem::DrawPipeline(Frame& frame, const Channels& channels) const {
+   const auto& cells = frame.mCells;
+   if (cells.GetCount() < ParallelCells or mPool->GetThreadCount() < 2) {
+      mTouchedCells = DrawRows<LAYOUT>(frame, channels, 0, cells.mHeight, mGlyphs.GetCache());
+      return;
+   }
+
+   // Split the image into bands of rows, and convert them in parallel  
+   // - each band has its own grapheme cache, that persists between     
+   // frames, because bands always cover the same rows                  
+   const auto bandRows = ::std::max(BandCells / cells.mWidth, 1u);
+   const auto bands = (cells.mHeight + bandRows - 1) / bandRows;
+   if (mBandCaches.size() < bands)
+      mBandCaches.resize(bands);
+
+   ::std::atomic<Count> touched {0};
+   mPool->Run(bands, [&](uint32_t band) {
+      const auto begin = band * bandRows;
+      const auto end = ::std::min(begin + bandRows, cells.mHeight);
+      touched.fetch_add(
+         DrawRows<LAYOUT>(frame, channels, begin, end, mBandCaches[band]),
+         ::std::memory_order_relaxed
+      );
+   });
+   mTouchedCells = touched.load(::std::memory_order_relaxed);
+}
+
+/// Convert a band of rows of an image to cells                               
+/// Bands can be converted in parallel, as long as they don't overlap         
+///   @param frame - the frame to convert to                                  
+///   @param channels - the raw channels of the whole image                   
+///   @param begin - the first row of the band                                
+///   @param end - the row after the last row of the band                     
+///   @param glyphCache - grapheme cache, owned by the calling thread         
+///   @return the number of cells that were touched                           
+template<GUISystem::Layout LAYOUT>
+auto GUISystem::DrawRows(
+   Frame& frame, const Channels& channels,
+   uint32_t begin, uint32_t end, GlyphTable::Cache& glyphCache
+) const -> Count {
+   if constexpr (LAYOUT == Layout::HalfBlocks)
+      return DrawHalfBlocks(frame, channels, begin, end);
+
+   constexpr bool HasColors = LAYOUT >= Layout::Colors;
+   constexpr bool HasSymbols = LAYOUT >= Layout::Symbols;
+   constexpr bool HasStyles = LAYOUT >= Layout::Styles;
+   auto& cells = frame.mCells;
+   const auto width = cells.mWidth;
+   const auto first = cells.RowOffset(begin);
+   auto bgColor_raw = channels.mBg + first;
+   auto fgColor_raw = HasColors and channels.mFg ? channels.mFg + first : nullptr;
+   auto symbols_raw = HasSymbols ? channels.mSymbols + first : nullptr;
+   auto styles_raw = HasStyles ? channels.mStyles + first : nullptr;
+   Count touched = 0;
+
+   const auto advance = [&] {
+      bgColor_raw += width;
+      if (fgColor_raw)
+         fgColor_raw += width;
+      if constexpr (HasSymbols)
+         symbols_raw += width;
+      if constexpr (HasStyles)
+         styles_raw += width;
+   };
+
+   for (uint32_t y = begin; y < end; ++y) {
+      // Skip rows that are already in this frame - it might be a few   
+      // frames old, but those rows haven't changed since               
+      const auto hash = HashRow(
+         HashMix(static_cast<uint64_t>(LAYOUT), mPalette.GetSeed()),
+         bgColor_raw, fgColor_raw, symbols_raw, styles_raw, width);
+      if (hash == frame.mRowHashes[y]) {
+         advance();
+         continue;
+      }
+
+      frame.mRowHashes[y] = hash;
+      touched += width;
+
+      const auto offset = cells.RowOffset(y);
+      const auto glyphs = cells.mGlyphs.data() + offset;
+      const auto fg = cells.mFg.data() + offset;
+      const auto bg = cells.mBg.data() + offset;
+
+      // Convert the colors of the whole row at once - readable         
+      // foreground shades are derived in the same pass, only if the    
+      // image doesn't provide its own foreground colors                
+      const bool derive = HasColors and not fgColor_raw;
+      mConvert(reinterpret_cast<const float*>(bgColor_raw), width, bg, derive ? fg : nullptr);
+      if (fgColor_raw)
+         mConvert(reinterpret_cast<const float*>(fgColor_raw), width, fg, nullptr);
+      mPalette.Quantize(bg, width, y);
+
+      if constexpr (not HasColors) {
          // Only color data available                                   
-         const auto& c = (*colorData)[0].As<TMany<Math::RGBAf>>(0);
-         auto c_raw = c.GetRaw();
-
-         // Build an ftxui::Image                                       
-         auto p = mBackbuffer.get_pixels().data();
-         for (uint32_t y = 0; y < image.GetView().mHeight; ++y) {
-            for (uint32_t x = 0; x < image.GetView().mWidth; ++x) {
-               p->grapheme = ' ';
-               p->style.background_color = Color {static_cast<uint8_t>(c_raw->r * 255), static_cast<uint8_t>(c_raw->g * 255), static_cast<uint8_t>(c_raw->b * 255)};
-               p->style.foreground_color = p->style.background_color;
-
-               p->style.blink = false;
-               p->style.bold = false;
-               p->style.dim = false;
-               p->style.italic = false;
-               p->style.inverted = false;
-               p->style.underlined = false;
-               p->style.underlined_double = false;
-               p->style.strikethrough = false;
-               p->style.automerge = false;
-
-               ++c_raw;
-               ++p;
-            }
-         }
+         ::std::copy_n(bg, width, fg);
+      }
+      else mPalette.Quantize(fg, width, y);
 
-         return true;
+      if constexpr (HasSymbols) {
+         for (uint32_t x = 0; x < width; ++x)
+            glyphs[x] = mGlyphs.Intern(symbols_raw[x], glyphCache);
       }
-      catch (...) {}
-   }*/
+      else ::std::fill_n(glyphs, width, GlyphTable::Space);
 
-   return true;
+      // Emphasis is translated through a table, without testing flags  
+      const auto styles = cells.mStyles.data() + offset;
+      if constexpr (HasStyles) {
+         mTranslate(reinterpret_cast<const uint8_t*>(styles_raw), width,
+            EmphasisStyles.data(), styles);
+      }
+      else ::std::fill_n(styles, width, uint8_t {});
+
+      advance();
+   }
+
+   return touched;
+}
+
+/// Convert a band of rows of a color-only image to half blocks               
+/// Each cell is an upper half block, colored by the pixel above with its     
+/// foreground, and by the pixel below with its background. Both rows are     
+/// converted straight into the backbuffer, without intermediate copies       
+///   @param frame - the frame to convert to                                  
+///   @param channels - the raw channels of the whole image                   
+///   @param begin - the first row of cells of the band                       
+///   @param end - the row of cells after the last row of the band            
+///   @return the number of cells that were touched                           
+auto GUISystem::DrawHalfBlocks(
+   Frame& frame, const Channels& channels, uint32_t begin, uint32_t end
+) const -> Count {
+   auto& cells = frame.mCells;
+   const auto width = cells.mWidth;
+   Count touched = 0;
+
+   for (uint32_t y = begin; y < end; ++y) {
+      // An image with an odd height has no pixels below the last row   
+      const auto top = channels.mBg + size_t {y} * 2 * width;
+      const auto bottom = y * 2 + 1 < channels.mHeight ? top + width : nullptr;
+      const auto hash = HashRow(
+         HashMix(static_cast<uint64_t>(Layout::HalfBlocks), mPalette.GetSeed()),
+         top, bottom, nullptr, nullptr, width);
+      if (hash == frame.mRowHashes[y])
+         continue;
+
+      frame.mRowHashes[y] = hash;
+      touched += width;
+
+      const auto offset = cells.RowOffset(y);
+      const auto fg = cells.mFg.data() + offset;
+      const auto bg = cells.mBg.data() + offset;
+      mConvert(reinterpret_cast<const float*>(top), width, fg, nullptr);
+      mPalette.Quantize(fg, width, y * 2);
+      if (bottom) {
+         mConvert(reinterpret_cast<const float*>(bottom), width, bg, nullptr);
+         mPalette.Quantize(bg, width, y * 2 + 1);
+      }
+      else ::std::copy_n(fg, width, bg);
+
+      ::std::fill_n(cells.mGlyphs.data() + offset, width, mHalfBlock);
+      ::std::fill_n(cells.mStyles.data() + offset, width, uint8_t {});
+   }
+
+   return touched;
 }
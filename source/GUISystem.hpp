@@ -8,10 +8,25 @@
 #pragma once
 #include "GUIItem.hpp"
 #include "GUIEditor.hpp"
+#include "Cells.hpp"
+#include "TripleBuffer.hpp"
+#include "Encoder.hpp"
+#include "Palette.hpp"
+#include "WorkPool.hpp"
+#include "InputBatch.hpp"
+#include "Histogram.hpp"
 #include <Langulus/Flow/Factory.hpp>
+#include <Langulus/Verbs/Select.hpp>
+#include <Langulus/Verbs/Associate.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/component/loop.hpp>
 #include <Langulus/Image.hpp>
+#include <Langulus/Math/Color.hpp>
+#include <mutex>
+#include <thread>
+
+
+ftxui::Color ToColor(Kernels::RGB8) noexcept;
 
 
 ///                                                                           
@@ -21,37 +36,281 @@
 /// isolated system. Also acts as A::Window, since ASCII graphics are         
 /// displayed in a console window, and usually there's only one associated    
 /// with a process at any given time.                                         
+///   Frames are either drawn as images, that get converted to cells, or      
+/// drawn as cells in the module's own layout, which skips the conversion.    
+/// Code that links with this module can draw straight into the backbuffer,   
+/// with AcquireCells and CommitCells. Other modules discover the native      
+/// format through Verbs::Select with Traits::CellFormat, and hand cells      
+/// over with Verbs::Associate, without this module's headers - only rows     
+/// that changed since the backbuffer was last drawn are copied.              
 ///                                                                           
 struct GUISystem final : A::UISystem, A::Window, ProducedFrom<GUI> {
    LANGULUS(ABSTRACT) false;
    LANGULUS(PRODUCER) GUI;
    LANGULUS_BASES(A::UISystem, A::Window);
-   LANGULUS_VERBS(Verbs::Create);
+   LANGULUS_VERBS(Verbs::Create, Verbs::Select, Verbs::Associate);
+
+   /// Rolling per-frame statistics, recorded without any allocations         
+   struct FrameStats {
+      // Nanoseconds spent converting an image to cells, per Draw       
+      Histogram mConvert;
+      // Nanoseconds spent running the FTXUI loop - layout, rendering,  
+      // and full redraws - per run, when not threaded                  
+      Histogram mLayout;
+      // Nanoseconds spent encoding and writing a frame to the terminal 
+      Histogram mWrite;
+      // Cells converted per Draw                                       
+      Histogram mCells;
+      // Bytes written to the terminal per presented frame              
+      Histogram mBytes;
+      // Input events dispatched per update                             
+      Histogram mInput;
+   };
 
 private:
-   // List of created GUI items                                         
+   /// Ways an ASCII image can be laid out, from least to most detailed       
+   enum class Layout : uint8_t {
+      Unsupported,   // Image can't be interpreted
+      Background,    // A single color channel
+      HalfBlocks,    // A single color channel, two pixels per cell
+      Colors,        // Foreground and background color channels
+      Symbols,       // Colors, and a symbol per cell
+      Styles         // Colors, symbols, and emphasis per cell
+   };
+
+   /// Raw image channels, gathered according to a layout                     
+   struct Channels {
+      const Math::RGBAf* mFg {};
+      const Math::RGBAf* mBg {};
+      const ::std::string_view* mSymbols {};
+      const Logger::Emphasis* mStyles {};
+      // Height of the image in pixels, which differs from the height   
+      // in cells, when pixels are drawn as half blocks                 
+      uint32_t mHeight {};
+   };
+
+   /// Types of the image channels, used to detect format changes             
+   struct ImageFormat {
+      DMeta mColors[2] {};
+      DMeta mData[2] {};
+
+      static auto From(const A::Image&) -> ImageFormat;
+      bool operator == (const ImageFormat&) const = default;
+   };
+
+   /// A frame, exchanged between the renderer and the terminal               
+   struct Frame {
+      // The converted cells                                            
+      CellBuffer mCells;
+      // Hash of the image row each row of cells was converted from -   
+      // rows with a matching hash are skipped completely when drawing  
+      ::std::vector<uint64_t> mRowHashes;
+   };
+
+   /// An image FTXUI displays, and the rows that were expanded to it         
+   struct Output {
+      ftxui::Image mImage {1, 1};
+      // Hash of the frame row each row of pixels was expanded from     
+      ::std::vector<uint64_t> mHashes;
+      // When the image was last displayed, to find the least recent    
+      uint64_t mLastUse {};
+      // The element displaying the image, reused between renders       
+      ftxui::Element mElement;
+   };
+
+   using Pipeline = void (GUISystem::*)(Frame&, const Channels&) const;
+
+   // Images with fewer cells are always converted on a single thread   
+   static constexpr Count ParallelCells = 32 * 1024;
+   // Approximate number of cells in a band of rows, converted as a     
+   // single task when converting in parallel                           
+   static constexpr uint32_t BandCells = 8 * 1024;
+
+   // List of created GUI items, guarded by the mutex, because they're  
+   // composed by the thread that renders                               
    TFactory<GUIItem> mItems;
-   // An editor interface                                               
+   ::std::mutex mItemsMutex;
+   // Bumped whenever items are created or destroyed                    
+   uint64_t mItemsVersion {};
+   // An editor interface, shown below the image, if enabled by the     
+   // Editor trait, along with its height in rows                       
    GUIEditor* mEditor {};
+   int mEditorSize = 16;
 
    // Rendering context                                                 
    ftxui::ScreenInteractive mScreen;
    // Main loop for drawing, and reading console input                  
    ftxui::Loop* mLoop {};
+   // The component tree, handed to the loop                            
+   ftxui::Component mRoot;
+   // The image with all items laid over it, composed again only when   
+   // items were created or destroyed, or another image is displayed -  
+   // items whose traits changed rebuild only their own elements        
+   ftxui::Element mComposed;
+   ftxui::Elements mComposedItems;
+   uint64_t mComposedVersion {};
+   const Output* mComposedOutput {};
+
+   // Whether the tree is rendered to a screen in memory, instead of a  
+   // terminal - no loop is created in this case                        
+   bool mHeadless = false;
+   ftxui::Screen mOffscreen {1, 1};
+   // Set in headless mode, when a real terminal would've been redrawn  
+   bool mRedraw = false;
+
+   // Whether the loop runs on a dedicated terminal I/O thread          
+   bool mThreaded = false;
+   ::std::thread mThread;
+   // Set to stop the terminal I/O thread                               
+   ::std::atomic<bool> mStop {false};
+   // Set by the terminal I/O thread, when the loop quits               
+   ::std::atomic<bool> mQuit {false};
+   // Set while the loop has a pending wake-up for a new frame, so that 
+   // no matter how many frames are drawn, only one wake-up is queued   
+   mutable ::std::atomic<bool> mWakePending {false};
+
+   /// Things that make the loop run, when not threaded                       
+   enum Changes : uint8_t {
+      ChangedFrame = 1 << 0,
+      ChangedInput = 1 << 1,
+      ChangedSize  = 1 << 2,
+      ChangedState = 1 << 3
+   };
+
+   // Changes, reported by Invalidate since the loop last ran           
+   ::std::atomic<uint8_t> mChanges {0};
+   // Terminal size when the loop last ran, or size of the offscreen    
+   // screen in headless mode                                           
+   ftxui::Dimensions mTerminalSize {};
+   // Terminal size reported to the producer - a resize is propagated   
+   // only once the size stops changing, instead of on every step of a  
+   // drag. The size that is waiting to settle, and the Stamp at which  
+   // it will, if it doesn't change until then                          
+   ftxui::Dimensions mSettledSize {};
+   ftxui::Dimensions mSettlingSize {};
+   uint64_t mSettleAt {};
+   Time mSettleDelay = ::std::chrono::milliseconds {100};
+   // Time since the loop last ran, and the longest it may stay idle    
+   Time mIdle {};
+   Time mKeepAlive = ::std::chrono::seconds {1};
+   // The loop keeps running for a while after input, until this Stamp, 
+   // in case it holds more of it                                       
+   uint64_t mInputUntil {};
+   Time mInputLinger = ::std::chrono::milliseconds {100};
+   // Number of updates that didn't run the loop                        
+   Count mIdleUpdates {};
+
+   // Input events caught by the loop, translated and coalesced,        
+   // waiting for the main thread                                       
+   InputBatch mInputBatch;
+   // Buttons held down, as seen by the loop, which alone changes them  
+   MouseButtons mMouseButtons;
+   // The batch of input events the main thread dispatches this update  
+   ::std::vector<InputEvent> mInput;
+
+   // Graphemes used by the frames                                      
+   mutable GlyphTable mGlyphs;
+   // Held while the loop reads frames, so that the graphemes in them   
+   // can be recycled on the main thread                                
+   mutable ::std::mutex mGlyphsMutex;
+   // Number of graphemes kept, when the table was last recycled        
+   mutable uint32_t mGlyphsKept {};
+   // Whether color-only images are drawn with two pixels per cell,     
+   // using the upper half block, and the grapheme for it               
+   bool mHalfBlocks = false;
+   mutable GlyphID mHalfBlock {};
+   // Grapheme caches for each band of rows, when drawing in parallel   
+   mutable ::std::vector<GlyphTable::Cache> mBandCaches;
+   // Threads of the producer, shared with other systems                
+   WorkPool* mPool;
+   // Backbuffers that get filled by the renderer module, and picked up 
+   // by the FTXUI loop, without locks, possibly on different threads   
+   mutable TripleBuffer<Frame> mFrames;
+   // Images of the sizes FTXUI displayed most recently - cells are     
+   // expanded to one only when emitted, and only where they changed,   
+   // and going back to a recent size doesn't reallocate any pixels     
+   static constexpr uint32_t OutputPool = 3;
+   Output mOutputs[OutputPool];
+   // The image FTXUI displays                                          
+   Output* mOutput = mOutputs;
+   uint64_t mOutputUses {};
+   // Whether the image is the only thing displayed, so that frames can 
+   // be written to the terminal without involving FTXUI - set from the 
+   // main thread, when items are created                               
+   ::std::atomic<bool> mDirectOutput {true};
+   // Encodes only the differences between written frames               
+   mutable Encoder mEncoder;
+   mutable ::std::string mEncoded;
+   // Set in headless mode, when the offscreen screen was rendered, but 
+   // not yet turned to text                                            
+   mutable bool mOffscreenDirty = false;
+   // Number of cells that were converted during the last Draw          
+   mutable Count mTouchedCells {};
+   // Number of drawn frames that were never picked up by the loop      
+   mutable Count mDroppedFrames {};
+   // Timings and sizes of recent frames                                
+   mutable FrameStats mStats;
+   // The fastest color conversion kernel, supported by the CPU         
+   Kernels::ConvertFunction mConvert;
+   // The fastest emphasis translation kernel, supported by the CPU     
+   Kernels::TranslateFunction mTranslate;
+   // Quantizes converted colors, if the terminal lacks truecolor       
+   Palette mPalette;
+   // Format of the last drawn image, and the pipeline that handles it  
+   mutable ImageFormat mFormat;
+   mutable Layout mLayout = Layout::Unsupported;
+   mutable Pipeline mPipeline {};
 
-   // A backbuffer that gets filled by the renderer module              
-   mutable ftxui::Image mBackbuffer;
+   static auto DetectLayout(const A::Image&) -> Layout;
+   static auto GetPipeline(Layout) noexcept -> Pipeline;
+   template<Layout>
+   void DrawPipeline(Frame&, const Channels&) const;
+   template<Layout>
+   auto DrawRows(Frame&, const Channels&, uint32_t, uint32_t, GlyphTable::Cache&) const -> Count;
+   auto DrawHalfBlocks(Frame&, const Channels&, uint32_t, uint32_t) const -> Count;
+   void DrawChannels(uint32_t, const Channels&) const;
+   void ReserveGlyphs(Count) const;
+   auto GetTerminalSize() const noexcept -> Scale2;
+   void PublishFrame() const;
+   auto Compose() -> ftxui::Element;
+   void Emit();
+   auto AcquireOutput(uint32_t, uint32_t) -> Output&;
+   bool SettleSize();
+   void ResizeOffscreen(const Scale2&);
+   void Present();
+   void RequestRedraw();
+   auto CollectChanges() -> uint8_t;
+   void RunTerminal();
+   void CatchInput(const ftxui::Event&);
+   void CatchResize(const ftxui::Dimensions&);
+   void Dispatch();
 
 public:
    GUISystem(GUI*, const Many&);
    ~GUISystem();
 
    void Create(Verb&);
+   void Select(Verb&);
+   void Associate(Verb&);
 
    void* GetNativeHandle() const noexcept;
    auto GetSize() const noexcept -> Scale2;
    bool IsMinimized() const noexcept;
+   auto GetTouchedCells() const noexcept -> Count;
+   auto GetDroppedFrames() const noexcept -> Count;
+   auto GetOutputStats() const noexcept -> const Encoder::Stats&;
+   auto GetCells() const noexcept -> const CellBuffer&;
+   auto GetGlyphs() const noexcept -> const GlyphTable&;
+   auto GetOutput() const -> const ::std::string&;
+   auto GetOffscreen() const noexcept -> const ftxui::Screen&;
+   void Invalidate();
+   auto GetIdleUpdates() const noexcept -> Count;
+   auto GetInputStats() const -> InputBatch::Stats;
+   auto GetStats() const noexcept -> const FrameStats&;
    bool Draw(const Langulus::Ref<A::Image>&) const;
+   auto AcquireCells(uint32_t, uint32_t) -> CellBuffer&;
+   auto InternGlyph(::std::string_view) -> GlyphID;
+   void CommitCells();
    bool Update(Time);
    void Refresh();
    void Teardown();
@@ -0,0 +1,118 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Histogram.hpp"
+#include <algorithm>
+#include <bit>
+
+
+/// Create a histogram                                                        
+///   @param window - samples per generation                                  
+Histogram::Histogram(uint32_t window) noexcept
+   : mWindow {::std::max(window, 1u)} {}
+
+/// Get the bucket of a value                                                 
+/// Values below four have buckets of their own, larger ones are split in     
+/// four buckets per power of two                                             
+///   @param value - the value                                                
+///   @return the bucket index                                                
+auto Histogram::BucketOf(uint64_t value) noexcept -> uint32_t {
+   if (value < SubBuckets)
+      return static_cast<uint32_t>(value);
+
+   const auto octave = static_cast<uint32_t>(63 - ::std::countl_zero(value));
+   const auto sub = static_cast<uint32_t>(value >> (octave - SubBits)) & (SubBuckets - 1);
+   return (octave - SubBits + 1) * SubBuckets + sub;
+}
+
+/// Get the smallest value that falls in a bucket                             
+///   @param bucket - the bucket index                                        
+///   @return the value                                                       
+auto Histogram::LowerBound(uint32_t bucket) noexcept -> uint64_t {
+   if (bucket < SubBuckets)
+      return bucket;
+
+   const auto octave = bucket / SubBuckets + SubBits - 1;
+   const auto sub = bucket % SubBuckets;
+   return (uint64_t {1} << octave) | (uint64_t {sub} << (octave - SubBits));
+}
+
+/// Clear a generation                                                        
+void Histogram::Generation::Reset() noexcept {
+   mCount.store(0, ::std::memory_order_relaxed);
+   mSum.store(0, ::std::memory_order_relaxed);
+   mMin.store(UINT64_MAX, ::std::memory_order_relaxed);
+   mMax.store(0, ::std::memory_order_relaxed);
+   for (auto& bucket : mBuckets)
+      bucket.store(0, ::std::memory_order_relaxed);
+}
+
+/// Record a sample                                                           
+///   @param value - the sample                                               
+void Histogram::Record(uint64_t value) noexcept {
+   const auto current = mCurrent.load(::std::memory_order_acquire);
+   auto& generation = mGenerations[current];
+   generation.mBuckets[BucketOf(value)].fetch_add(1, ::std::memory_order_relaxed);
+   generation.mSum.fetch_add(value, ::std::memory_order_relaxed);
+
+   auto min = generation.mMin.load(::std::memory_order_relaxed);
+   while (value < min and not generation.mMin.compare_exchange_weak(min, value, ::std::memory_order_relaxed));
+   auto max = generation.mMax.load(::std::memory_order_relaxed);
+   while (value > max and not generation.mMax.compare_exchange_weak(max, value, ::std::memory_order_relaxed));
+
+   // The sample that fills the window retires the older generation     
+   if (generation.mCount.fetch_add(1, ::std::memory_order_acq_rel) + 1 == mWindow) {
+      mGenerations[current ^ 1].Reset();
+      mCurrent.store(current ^ 1, ::std::memory_order_release);
+   }
+}
+
+/// Forget all samples                                                        
+void Histogram::Reset() noexcept {
+   mGenerations[0].Reset();
+   mGenerations[1].Reset();
+   mCurrent.store(0, ::std::memory_order_release);
+}
+
+/// Copy the samples of both generations                                      
+/// Samples recorded while copying might be partially included                
+///   @return the snapshot                                                    
+auto Histogram::GetSnapshot() const noexcept -> Snapshot {
+   Snapshot snapshot;
+   snapshot.mMin = UINT64_MAX;
+   for (auto& generation : mGenerations) {
+      snapshot.mCount += generation.mCount.load(::std::memory_order_relaxed);
+      snapshot.mSum += generation.mSum.load(::std::memory_order_relaxed);
+      snapshot.mMin = ::std::min(snapshot.mMin, generation.mMin.load(::std::memory_order_relaxed));
+      snapshot.mMax = ::std::max(snapshot.mMax, generation.mMax.load(::std::memory_order_relaxed));
+      for (uint32_t i = 0; i < Buckets; ++i)
+         snapshot.mBuckets[i] += generation.mBuckets[i].load(::std::memory_order_relaxed);
+   }
+
+   if (not snapshot.mCount)
+      snapshot.mMin = 0;
+   return snapshot;
+}
+
+/// Estimate a percentile                                                     
+///   @param p - the percentile, between 0 and 100                            
+///   @return the smallest value of the bucket the percentile falls in,       
+///           clamped to the recorded range                                   
+auto Histogram::Snapshot::Percentile(double p) const noexcept -> uint64_t {
+   if (not mCount)
+      return 0;
+
+   const auto last = static_cast<double>(mCount - 1);
+   const auto rank = static_cast<uint64_t>(::std::clamp(p, 0.0, 100.0) / 100.0 * last);
+   uint64_t seen = 0;
+   for (uint32_t i = 0; i < Buckets; ++i) {
+      seen += mBuckets[i];
+      if (seen > rank)
+         return ::std::clamp(LowerBound(i), mMin, mMax);
+   }
+   return mMax;
+}
@@ -0,0 +1,69 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+
+///                                                                           
+///   Rolling histogram                                                       
+///                                                                           
+///   Records samples in fixed logarithmic buckets - four per power of two,   
+/// so any value is placed within 25% of its actual size - without ever       
+/// allocating. Samples are kept in two generations: once the current one     
+/// holds a window of samples, the older is cleared and takes its place, so   
+/// snapshots always describe the last one to two windows. Recording is       
+/// lock-free, and safe from any thread.                                      
+///                                                                           
+class Histogram {
+public:
+   static constexpr uint32_t SubBits = 2;
+   static constexpr uint32_t SubBuckets = 1u << SubBits;
+   static constexpr uint32_t Buckets = (64 - SubBits + 1) * SubBuckets;
+
+   /// A consistent copy of the recorded samples                              
+   struct Snapshot {
+      uint64_t mCount {};
+      uint64_t mSum {};
+      uint64_t mMin {};
+      uint64_t mMax {};
+      uint32_t mBuckets[Buckets] {};
+
+      auto Percentile(double) const noexcept -> uint64_t;
+
+      /// Get the average of all samples                                      
+      uint64_t Mean() const noexcept {
+         return mCount ? mSum / mCount : 0;
+      }
+   };
+
+   Histogram(uint32_t window = 256) noexcept;
+
+   void Record(uint64_t) noexcept;
+   void Reset() noexcept;
+   auto GetSnapshot() const noexcept -> Snapshot;
+
+   static auto BucketOf(uint64_t) noexcept -> uint32_t;
+   static auto LowerBound(uint32_t) noexcept -> uint64_t;
+
+private:
+   /// A generation of samples                                                
+   struct Generation {
+      ::std::atomic<uint64_t> mCount {};
+      ::std::atomic<uint64_t> mSum {};
+      ::std::atomic<uint64_t> mMin {UINT64_MAX};
+      ::std::atomic<uint64_t> mMax {};
+      ::std::atomic<uint32_t> mBuckets[Buckets] {};
+
+      void Reset() noexcept;
+   };
+
+   Generation mGenerations[2];
+   ::std::atomic<uint32_t> mCurrent {0};
+   uint32_t mWindow;
+};
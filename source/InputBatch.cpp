@@ -0,0 +1,108 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "InputBatch.hpp"
+
+
+/// Translate a report about a button to a button event, or to motion, if     
+/// the button was already held, or the report says so                        
+///   @param button - one of InputEvent::Buttons                              
+///   @param report - what the terminal reported about the button             
+///   @param out - [out] the event, its position is left as it is             
+void MouseButtons::Translate(uint8_t button, Report report, InputEvent& out) noexcept {
+   const auto bit = static_cast<uint8_t>(1u << button);
+   const bool held = mHeld & bit;
+   if (report == Released)
+      mHeld &= static_cast<uint8_t>(~bit);
+   else
+      mHeld |= bit;
+
+   out.mButton = button;
+   out.mButtons = mHeld;
+   out.mPressed = report != Released;
+   out.mKind = report == Moved or (report == Pressed and held)
+      ? InputEvent::MouseMove : InputEvent::MouseButton;
+}
+
+/// Translate motion without any button reported                              
+///   @param out - [out] the event, its position is left as it is             
+void MouseButtons::Move(InputEvent& out) const noexcept {
+   out.mKind = InputEvent::MouseMove;
+   out.mButtons = mHeld;
+}
+
+/// Collect an event, merging it with an earlier one of the same kind, if     
+/// that kind is coalesced, and no other event was collected in between that  
+/// isn't                                                                     
+///   @param event - the event                                                
+void InputBatch::Push(const InputEvent& event) {
+   ::std::scoped_lock lock {mMutex};
+   ++mStats.mPushed;
+
+   uint32_t* slot = nullptr;
+   switch (event.mKind) {
+   case InputEvent::MouseMove:
+      slot = &mMove;
+      break;
+   case InputEvent::Scroll:
+      slot = &mScroll;
+      break;
+   case InputEvent::Resize:
+      slot = &mResize;
+      break;
+   default:
+      // Later motion must not be merged into an event that precedes    
+      // this one, or it would be delivered before it                   
+      mMove = mScroll = mResize = None;
+      mPending.push_back(event);
+      return;
+   }
+
+   if (*slot == None) {
+      *slot = static_cast<uint32_t>(mPending.size());
+      mPending.push_back(event);
+      return;
+   }
+
+   // Keep the latest state, but accumulate scrolling, and only while   
+   // scrolling in the same direction with the same modifiers           
+   auto& merged = mPending[*slot];
+   if (event.mKind == InputEvent::Scroll
+   and (merged.mModifiers != event.mModifiers or (merged.mDelta > 0) != (event.mDelta > 0))) {
+      *slot = static_cast<uint32_t>(mPending.size());
+      mPending.push_back(event);
+      return;
+   }
+
+   const auto delta = merged.mDelta;
+   merged = event;
+   if (event.mKind == InputEvent::Scroll)
+      merged.mDelta += delta;
+   ++mStats.mCoalesced;
+}
+
+/// Take all collected events                                                 
+///   @param out - [out] the events, replaced; its storage is recycled        
+///   @return true if there were any events                                   
+bool InputBatch::Take(::std::vector<InputEvent>& out) {
+   out.clear();
+   ::std::scoped_lock lock {mMutex};
+   if (mPending.empty())
+      return false;
+
+   out.swap(mPending);
+   mMove = mScroll = mResize = None;
+   ++mStats.mBatches;
+   return true;
+}
+
+/// Get the statistics                                                        
+///   @return the statistics                                                  
+auto InputBatch::GetStats() const -> Stats {
+   ::std::scoped_lock lock {mMutex};
+   return mStats;
+}
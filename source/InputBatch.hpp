@@ -0,0 +1,124 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+
+///                                                                           
+///   A terminal input event, independent of FTXUI and Langulus               
+///                                                                           
+struct InputEvent {
+   enum Kind : uint8_t {
+      Key,           // A special key, mKey being one of Keys
+      Character,     // A printable character, as UTF-8 in mText
+      MouseMove,     // Pointer moved to mX, mY, with mButtons held
+      MouseButton,   // mButton pressed or released at mX, mY
+      Scroll,        // Wheel scrolled by mDelta at mX, mY
+      Resize         // Terminal resized to mX by mY cells
+   };
+
+   /// Special keys                                                           
+   enum Keys : uint8_t {
+      Return, Escape, Tab, TabReverse, Backspace, Delete, Insert,
+      Home, End, PageUp, PageDown, Up, Down, Left, Right,
+      F1, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12
+   };
+
+   /// Mouse buttons                                                          
+   enum Buttons : uint8_t {
+      ButtonLeft, ButtonMiddle, ButtonRight
+   };
+
+   /// Modifier bits                                                          
+   enum Modifiers : uint8_t {
+      Shift   = 1 << 0,
+      Control = 1 << 1,
+      Meta    = 1 << 2
+   };
+
+   Kind mKind {};
+   uint8_t mKey {};
+   uint8_t mButton {};
+   // Bits of the buttons held, one for each of Buttons                 
+   uint8_t mButtons {};
+   uint8_t mModifiers {};
+   bool mPressed {};
+   int32_t mX {};
+   int32_t mY {};
+   int32_t mDelta {};
+   char mText[8] {};
+};
+
+
+///                                                                           
+///   Mouse buttons held down                                                 
+///                                                                           
+///   Terminals report pointer motion while a button is held down the same    
+/// way they report pressing it - as the button, pressed, only at another     
+/// position - and newer FTXUI reports it as the button, moved. Keeping track 
+/// of the held buttons tells the two apart, so that only pressing and        
+/// releasing a button make button events, and dragging makes motion, which   
+/// can be coalesced.                                                         
+///                                                                           
+class MouseButtons {
+public:
+   /// What a terminal reported about a button                                
+   enum Report : uint8_t {
+      Pressed, Released, Moved
+   };
+
+   void Translate(uint8_t button, Report, InputEvent&) noexcept;
+   void Move(InputEvent&) const noexcept;
+
+private:
+   uint8_t mHeld {};
+};
+
+
+///                                                                           
+///   Input batch                                                             
+///                                                                           
+///   Collects input events from the thread that reads the terminal, for the  
+/// main thread to take all at once, every update. Bursts of pointer motion,  
+/// scrolling and resizing are coalesced while collecting - each burst leaves 
+/// one event of its kind, carrying the latest state. Scrolling accumulates   
+/// its delta, but only while the direction and modifiers stay the same -     
+/// a change starts another event. Keys, characters and button presses are    
+/// never coalesced, and nothing is coalesced across them, so every event     
+/// is delivered in the order it happened relative to them.                   
+///                                                                           
+class InputBatch {
+public:
+   /// Statistics                                                             
+   struct Stats {
+      // Events pushed                                                  
+      uint64_t mPushed {};
+      // Events merged into an already collected one                    
+      uint64_t mCoalesced {};
+      // Batches taken that weren't empty                               
+      uint64_t mBatches {};
+   };
+
+   void Push(const InputEvent&);
+   bool Take(::std::vector<InputEvent>&);
+   auto GetStats() const -> Stats;
+
+private:
+   static constexpr uint32_t None = UINT32_MAX;
+
+   mutable ::std::mutex mMutex;
+   ::std::vector<InputEvent> mPending;
+   // Where the coalesced kinds are in mPending, if they can still be   
+   // merged into                                                       
+   uint32_t mMove = None;
+   uint32_t mScroll = None;
+   uint32_t mResize = None;
+   Stats mStats;
+};
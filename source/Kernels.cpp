@@ -0,0 +1,343 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Kernels.hpp"
+
+#if defined(__x86_64__) or defined(_M_X64) or defined(__i386__) or defined(_M_IX86)
+   #define KERNELS_X86 1
+   #include <immintrin.h>
+   #if defined(_MSC_VER) and not defined(__clang__)
+      #include <intrin.h>
+      #define KERNELS_TARGET_AVX2
+   #else
+      #define KERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+   #endif
+#else
+   #define KERNELS_X86 0
+#endif
+
+namespace Kernels {
+
+   /// Clamp a color component to the [0;1] range                             
+   /// NaNs are clamped too, so that the result is always well defined, and   
+   /// matches the vector kernels                                             
+   ///   @param c - the component                                             
+   ///   @return the clamped component                                        
+   inline float Clamp(float c) noexcept {
+      return c > 0.f ? (c < 1.f ? c : 1.f) : 0.f;
+   }
+
+   /// Convert a clamped color component to a byte                            
+   ///   @param c - the component                                             
+   ///   @return the byte                                                     
+   inline uint32_t ToByte(float c) noexcept {
+      return static_cast<uint32_t>(c * 255.f);
+   }
+
+   /// Get a grey shade that is readable on top of a background color         
+   /// Uses BT.601 luminance in double precision, with the very operations    
+   /// the original per-pixel formula used, so that shades are exactly the    
+   /// same - they are pushed away from the middle grey, where they'd blend   
+   /// with the background, so being off by one near the edges of that band   
+   /// would change them by a hundred                                         
+   ///   @param r, g, b - the clamped background components                   
+   ///   @return the packed grey shade                                        
+   inline RGB8 Shade(float r, float g, float b) noexcept {
+      const double luminance = r * 0.299 + g * 0.587 + b * 0.114;
+      auto fg = static_cast<uint32_t>(255 - luminance * 255);
+      if (fg >= 100 and fg <= 156)
+         fg -= 100;
+      return Pack(fg, fg, fg);
+   }
+
+   /// Reference conversion kernel, one pixel at a time                       
+   ///   @param rgba - count * 4 floats, interleaved RGBA                     
+   ///   @param count - number of pixels to convert                           
+   ///   @param bg - [out] packed background colors                           
+   ///   @param fg - [out] packed foreground colors, or nullptr to skip them  
+   void ConvertScalar(
+      const float* rgba, uint32_t count, RGB8* bg, RGB8* fg
+   ) noexcept {
+      for (uint32_t i = 0; i < count; ++i, rgba += 4) {
+         const auto r = Clamp(rgba[0]);
+         const auto g = Clamp(rgba[1]);
+         const auto b = Clamp(rgba[2]);
+         bg[i] = Pack(ToByte(r), ToByte(g), ToByte(b));
+         if (fg)
+            fg[i] = Shade(r, g, b);
+      }
+   }
+
+   /// Reference flag translation kernel, one byte at a time                  
+   ///   @param flags - count flag bytes                                      
+   ///   @param count - number of bytes to translate                          
+   ///   @param table - 256 translated bytes                                  
+   ///   @param out - [out] count translated bytes                            
+   void TranslateScalar(
+      const uint8_t* flags, uint32_t count, const uint8_t* table, uint8_t* out
+   ) noexcept {
+      for (uint32_t i = 0; i < count; ++i)
+         out[i] = table[flags[i]];
+   }
+
+#if KERNELS_X86
+   /// Get the shades of two pixels in double precision, with the same        
+   /// operations in the same order as the scalar kernel                      
+   ///   @param r, g, b - clamped components, of which the lower two are used 
+   ///   @return the shades, in the lower two integers                        
+   inline __m128i ShadeSSE2(__m128 r, __m128 g, __m128 b) noexcept {
+      const auto full = _mm_set1_pd(255);
+      const auto lum = _mm_add_pd(_mm_add_pd(
+         _mm_mul_pd(_mm_cvtps_pd(r), _mm_set1_pd(0.299)),
+         _mm_mul_pd(_mm_cvtps_pd(g), _mm_set1_pd(0.587))),
+         _mm_mul_pd(_mm_cvtps_pd(b), _mm_set1_pd(0.114)));
+      return _mm_cvttpd_epi32(_mm_sub_pd(full, _mm_mul_pd(lum, full)));
+   }
+
+   /// SSE2 conversion kernel, four pixels at a time                          
+   ///   @param rgba - count * 4 floats, interleaved RGBA                     
+   ///   @param count - number of pixels to convert                           
+   ///   @param bg - [out] packed background colors                           
+   ///   @param fg - [out] packed foreground colors, or nullptr to skip them  
+   void ConvertSSE2(
+      const float* rgba, uint32_t count, RGB8* bg, RGB8* fg
+   ) noexcept {
+      const auto zero = _mm_setzero_ps();
+      const auto one  = _mm_set1_ps(1.f);
+      const auto full = _mm_set1_ps(255.f);
+      const auto c99  = _mm_set1_epi32(99);
+      const auto c100 = _mm_set1_epi32(100);
+      const auto c157 = _mm_set1_epi32(157);
+
+      uint32_t i = 0;
+      for (; i + 4 <= count; i += 4, rgba += 16) {
+         // Transpose four RGBA pixels to RRRR GGGG BBBB AAAA           
+         auto r = _mm_loadu_ps(rgba + 0);
+         auto g = _mm_loadu_ps(rgba + 4);
+         auto b = _mm_loadu_ps(rgba + 8);
+         auto a = _mm_loadu_ps(rgba + 12);
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+
+         // Clamp and convert to bytes - max must come first, because   
+         // it returns its second operand for NaNs                      
+         r = _mm_min_ps(_mm_max_ps(r, zero), one);
+         g = _mm_min_ps(_mm_max_ps(g, zero), one);
+         b = _mm_min_ps(_mm_max_ps(b, zero), one);
+         const auto R = _mm_cvttps_epi32(_mm_mul_ps(r, full));
+         const auto G = _mm_cvttps_epi32(_mm_mul_ps(g, full));
+         const auto B = _mm_cvttps_epi32(_mm_mul_ps(b, full));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(bg + i), _mm_or_si128(R,
+            _mm_or_si128(_mm_slli_epi32(G, 8), _mm_slli_epi32(B, 16))));
+         if (not fg)
+            continue;
+
+         auto f = _mm_unpacklo_epi64(ShadeSSE2(r, g, b), ShadeSSE2(
+            _mm_movehl_ps(r, r), _mm_movehl_ps(g, g), _mm_movehl_ps(b, b)));
+         const auto mid = _mm_and_si128(
+            _mm_cmpgt_epi32(f, c99), _mm_cmplt_epi32(f, c157));
+         f = _mm_sub_epi32(f, _mm_and_si128(mid, c100));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(fg + i), _mm_or_si128(f,
+            _mm_or_si128(_mm_slli_epi32(f, 8), _mm_slli_epi32(f, 16))));
+      }
+
+      ConvertScalar(rgba, count - i, bg + i, fg ? fg + i : nullptr);
+   }
+
+   /// Get the shades of four pixels in double precision, with the same       
+   /// operations in the same order as the scalar kernel                      
+   ///   @param r, g, b - clamped components                                  
+   ///   @return the shades                                                   
+   KERNELS_TARGET_AVX2
+   inline __m128i ShadeAVX2(__m128 r, __m128 g, __m128 b) noexcept {
+      const auto full = _mm256_set1_pd(255);
+      const auto lum = _mm256_add_pd(_mm256_add_pd(
+         _mm256_mul_pd(_mm256_cvtps_pd(r), _mm256_set1_pd(0.299)),
+         _mm256_mul_pd(_mm256_cvtps_pd(g), _mm256_set1_pd(0.587))),
+         _mm256_mul_pd(_mm256_cvtps_pd(b), _mm256_set1_pd(0.114)));
+      return _mm256_cvttpd_epi32(_mm256_sub_pd(full, _mm256_mul_pd(lum, full)));
+   }
+
+   /// AVX2 conversion kernel, eight pixels at a time                         
+   ///   @param rgba - count * 4 floats, interleaved RGBA                     
+   ///   @param count - number of pixels to convert                           
+   ///   @param bg - [out] packed background colors                           
+   ///   @param fg - [out] packed foreground colors, or nullptr to skip them  
+   KERNELS_TARGET_AVX2
+   void ConvertAVX2(
+      const float* rgba, uint32_t count, RGB8* bg, RGB8* fg
+   ) noexcept {
+      const auto zero = _mm256_setzero_ps();
+      const auto one  = _mm256_set1_ps(1.f);
+      const auto full = _mm256_set1_ps(255.f);
+      const auto c99  = _mm256_set1_epi32(99);
+      const auto c100 = _mm256_set1_epi32(100);
+      const auto c157 = _mm256_set1_epi32(157);
+
+      uint32_t i = 0;
+      for (; i + 8 <= count; i += 8, rgba += 32) {
+         // Pair pixels N and N+4 in the two lanes, so that a lane-wise 
+         // transpose yields the components in order                    
+         const auto p04 = _mm256_insertf128_ps(_mm256_castps128_ps256(
+            _mm_loadu_ps(rgba + 0)),  _mm_loadu_ps(rgba + 16), 1);
+         const auto p15 = _mm256_insertf128_ps(_mm256_castps128_ps256(
+            _mm_loadu_ps(rgba + 4)),  _mm_loadu_ps(rgba + 20), 1);
+         const auto p26 = _mm256_insertf128_ps(_mm256_castps128_ps256(
+            _mm_loadu_ps(rgba + 8)),  _mm_loadu_ps(rgba + 24), 1);
+         const auto p37 = _mm256_insertf128_ps(_mm256_castps128_ps256(
+            _mm_loadu_ps(rgba + 12)), _mm_loadu_ps(rgba + 28), 1);
+
+         const auto t0 = _mm256_unpacklo_ps(p04, p15);
+         const auto t1 = _mm256_unpackhi_ps(p04, p15);
+         const auto t2 = _mm256_unpacklo_ps(p26, p37);
+         const auto t3 = _mm256_unpackhi_ps(p26, p37);
+         const auto r = _mm256_min_ps(_mm256_max_ps(
+            _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), zero), one);
+         const auto g = _mm256_min_ps(_mm256_max_ps(
+            _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)), zero), one);
+         const auto b = _mm256_min_ps(_mm256_max_ps(
+            _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), zero), one);
+
+         const auto R = _mm256_cvttps_epi32(_mm256_mul_ps(r, full));
+         const auto G = _mm256_cvttps_epi32(_mm256_mul_ps(g, full));
+         const auto B = _mm256_cvttps_epi32(_mm256_mul_ps(b, full));
+         _mm256_storeu_si256(reinterpret_cast<__m256i*>(bg + i), _mm256_or_si256(R,
+            _mm256_or_si256(_mm256_slli_epi32(G, 8), _mm256_slli_epi32(B, 16))));
+         if (not fg)
+            continue;
+
+         // Shades need double precision, so half as many at a time     
+         auto f = _mm256_inserti128_si256(_mm256_castsi128_si256(ShadeAVX2(
+               _mm256_castps256_ps128(r),
+               _mm256_castps256_ps128(g),
+               _mm256_castps256_ps128(b))),
+            ShadeAVX2(
+               _mm256_extractf128_ps(r, 1),
+               _mm256_extractf128_ps(g, 1),
+               _mm256_extractf128_ps(b, 1)), 1);
+         const auto mid = _mm256_and_si256(
+            _mm256_cmpgt_epi32(f, c99), _mm256_cmpgt_epi32(c157, f));
+         f = _mm256_sub_epi32(f, _mm256_and_si256(mid, c100));
+         _mm256_storeu_si256(reinterpret_cast<__m256i*>(fg + i), _mm256_or_si256(f,
+            _mm256_or_si256(_mm256_slli_epi32(f, 8), _mm256_slli_epi32(f, 16))));
+      }
+
+      ConvertSSE2(rgba, count - i, bg + i, fg ? fg + i : nullptr);
+   }
+
+   /// AVX2 flag translation kernel, 32 bytes at a time                       
+   /// Bits translate independently, so a byte is the combination of its low  
+   /// and high nibble, each looked up in a 16 byte table with a shuffle      
+   ///   @param flags - count flag bytes                                      
+   ///   @param count - number of bytes to translate                          
+   ///   @param table - 256 translated bytes                                  
+   ///   @param out - [out] count translated bytes                            
+   KERNELS_TARGET_AVX2
+   void TranslateAVX2(
+      const uint8_t* flags, uint32_t count, const uint8_t* table, uint8_t* out
+   ) noexcept {
+      alignas(16) uint8_t low[16];
+      alignas(16) uint8_t high[16];
+      for (int i = 0; i < 16; ++i) {
+         low[i] = table[i];
+         high[i] = table[i << 4];
+      }
+
+      const auto L = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(low)));
+      const auto H = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(high)));
+      const auto nibble = _mm256_set1_epi8(0x0F);
+
+      uint32_t i = 0;
+      for (; i + 32 <= count; i += 32) {
+         // There's no byte shift, but masking after a 16bit shift      
+         // leaves only the high nibble of each byte                    
+         const auto f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(flags + i));
+         const auto lo = _mm256_shuffle_epi8(L, _mm256_and_si256(f, nibble));
+         const auto hi = _mm256_shuffle_epi8(H, _mm256_and_si256(_mm256_srli_epi16(f, 4), nibble));
+         _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_or_si256(lo, hi));
+      }
+
+      TranslateScalar(flags + i, count - i, table, out + i);
+   }
+
+   /// Check if the running CPU and OS support AVX2                           
+   ///   @return true if AVX2 kernels can be used                             
+   bool SupportsAVX2() noexcept {
+   #if defined(_MSC_VER) and not defined(__clang__)
+      int info[4];
+      __cpuid(info, 0);
+      if (info[0] < 7)
+         return false;
+
+      // AVX must be enabled by the OS, via XSAVE                       
+      __cpuid(info, 1);
+      constexpr int OSXSAVE = 1 << 27;
+      constexpr int AVX = 1 << 28;
+      if ((info[2] & (OSXSAVE | AVX)) != (OSXSAVE | AVX))
+         return false;
+      if ((_xgetbv(0) & 6) != 6)
+         return false;
+
+      __cpuidex(info, 7, 0);
+      return (info[1] & (1 << 5)) != 0;
+   #else
+      return __builtin_cpu_supports("avx2");
+   #endif
+   }
+#endif
+
+   /// Get all conversion kernels that the running CPU supports               
+   /// The scalar reference kernel is always first                            
+   ///   @return the kernels                                                  
+   auto GetConvertKernels() noexcept -> ::std::span<const ConvertKernel> {
+      static const ConvertKernel all[] {
+         {"Scalar", ConvertScalar},
+      #if KERNELS_X86
+         {"SSE2", ConvertSSE2},
+         {"AVX2", ConvertAVX2},
+      #endif
+      };
+
+   #if KERNELS_X86
+      static const bool avx2 = SupportsAVX2();
+      return {all, avx2 ? 3u : 2u};
+   #else
+      return {all, 1u};
+   #endif
+   }
+
+   /// Get the fastest conversion kernel that the running CPU supports        
+   ///   @return the kernel                                                   
+   auto GetConvertKernel() noexcept -> const ConvertKernel& {
+      return GetConvertKernels().back();
+   }
+
+   /// Get all flag translation kernels that the running CPU supports         
+   /// The scalar reference kernel is always first                            
+   ///   @return the kernels                                                  
+   auto GetTranslateKernels() noexcept -> ::std::span<const TranslateKernel> {
+      static const TranslateKernel all[] {
+         {"Scalar", TranslateScalar},
+      #if KERNELS_X86
+         {"AVX2", TranslateAVX2},
+      #endif
+      };
+
+   #if KERNELS_X86
+      static const bool avx2 = SupportsAVX2();
+      return {all, avx2 ? 2u : 1u};
+   #else
+      return {all, 1u};
+   #endif
+   }
+
+   /// Get the fastest flag translation kernel that the running CPU supports  
+   ///   @return the kernel                                                   
+   auto GetTranslateKernel() noexcept -> const TranslateKernel& {
+      return GetTranslateKernels().back();
+   }
+
+} // namespace Kernels
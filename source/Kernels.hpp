@@ -0,0 +1,110 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include <cstdint>
+#include <span>
+
+
+///                                                                           
+///   Pixel conversion kernels                                                
+///                                                                           
+///   Hot loops that convert whole rows of renderer output to terminal cells. 
+/// They don't depend on Langulus or FTXUI, so that they can be compiled      
+/// directly into tests and benchmarks. Every vectorized kernel produces the  
+/// exact same bits as the scalar one, which serves as reference.             
+///                                                                           
+namespace Kernels {
+
+   /// A color packed as 0x00BBGGRR, red being the lowest byte                
+   using RGB8 = uint32_t;
+
+   /// Pack color components                                                  
+   ///   @param r, g, b - the components                                      
+   ///   @return the packed color                                             
+   constexpr RGB8 Pack(uint32_t r, uint32_t g, uint32_t b) noexcept {
+      return r | (g << 8) | (b << 16);
+   }
+
+   /// Get the red component of a packed color                                
+   constexpr uint8_t Red(RGB8 c) noexcept {
+      return static_cast<uint8_t>(c);
+   }
+
+   /// Get the green component of a packed color                              
+   constexpr uint8_t Green(RGB8 c) noexcept {
+      return static_cast<uint8_t>(c >> 8);
+   }
+
+   /// Get the blue component of a packed color                               
+   constexpr uint8_t Blue(RGB8 c) noexcept {
+      return static_cast<uint8_t>(c >> 16);
+   }
+
+   /// Packed colors can instead refer to a terminal palette entry, in which  
+   /// case the lowest byte is the index, and the highest byte tells which    
+   /// palette it belongs to                                                  
+   constexpr RGB8 Indexed256 = 1u << 24;
+   constexpr RGB8 Indexed16  = 2u << 24;
+   constexpr RGB8 IndexedMask = 0xFFu << 24;
+
+   /// Get the palette a packed color refers to                               
+   ///   @return Indexed256, Indexed16, or zero for a truecolor               
+   constexpr RGB8 PaletteOf(RGB8 c) noexcept {
+      return c & IndexedMask;
+   }
+
+   /// Get the palette index of a packed color                                
+   constexpr uint8_t Index(RGB8 c) noexcept {
+      return static_cast<uint8_t>(c);
+   }
+
+   /// Convert a row of RGBA float colors to packed background colors, and    
+   /// the grey foreground shades that remain readable on top of them         
+   ///   @param rgba - count * 4 floats, interleaved RGBA in the [0;1] range  
+   ///   @param count - number of pixels to convert                           
+   ///   @param bg - [out] count packed background colors                     
+   ///   @param fg - [out] count packed foreground colors, or nullptr if the  
+   ///               image provides its own                                   
+   using ConvertFunction = void(*)(
+      const float* rgba, uint32_t count, RGB8* bg, RGB8* fg
+   ) noexcept;
+
+   /// A named conversion kernel                                              
+   struct ConvertKernel {
+      const char* mName;
+      ConvertFunction mFunction;
+   };
+
+   void ConvertScalar(const float*, uint32_t, RGB8*, RGB8*) noexcept;
+
+   auto GetConvertKernels() noexcept -> ::std::span<const ConvertKernel>;
+   auto GetConvertKernel() noexcept -> const ConvertKernel&;
+
+   /// Translate a row of flag bytes through a 256-entry table                
+   /// The table must translate every bit on its own, and combine the         
+   /// results, so that vector kernels can look up each nibble separately     
+   ///   @param flags - count flag bytes                                      
+   ///   @param count - number of bytes to translate                          
+   ///   @param table - 256 translated bytes, one for each flag combination   
+   ///   @param out - [out] count translated bytes                            
+   using TranslateFunction = void(*)(
+      const uint8_t* flags, uint32_t count, const uint8_t* table, uint8_t* out
+   ) noexcept;
+
+   /// A named flag translation kernel                                        
+   struct TranslateKernel {
+      const char* mName;
+      TranslateFunction mFunction;
+   };
+
+   void TranslateScalar(const uint8_t*, uint32_t, const uint8_t*, uint8_t*) noexcept;
+
+   auto GetTranslateKernels() noexcept -> ::std::span<const TranslateKernel>;
+   auto GetTranslateKernel() noexcept -> const TranslateKernel&;
+
+} // namespace Kernels
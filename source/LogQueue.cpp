@@ -0,0 +1,158 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "LogQueue.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+
+/// Create a queue                                                            
+///   @param capacity - most fragments the queue holds, rounded up to a       
+///                     power of two                                          
+LogQueue::LogQueue(uint32_t capacity)
+   : mCells {::std::make_unique<Cell[]>(::std::bit_ceil(::std::max(capacity, 2u)))}
+   , mMask  {::std::bit_ceil(::std::max(capacity, 2u)) - 1ull} {
+   for (uint64_t i = 0; i <= mMask; ++i)
+      mCells[i].mSequence.store(i, ::std::memory_order_relaxed);
+}
+
+/// Get a small number that identifies the calling thread                     
+///   @return the identifier                                                  
+auto LogQueue::CurrentProducer() noexcept -> uint32_t {
+   static ::std::atomic<uint32_t> next {0};
+   thread_local const uint32_t id = next.fetch_add(1, ::std::memory_order_relaxed);
+   return id;
+}
+
+/// Push a fragment from the calling thread - never blocks                    
+/// Text that doesn't fit in a single cell is split in several fragments      
+///   @param kind - the kind of fragment                                      
+///   @param text - text of a Text fragment                                   
+///   @param color - color of a Style fragment                                
+///   @param style - style bits of a Style fragment                           
+///   @return false if the queue was full, and (part of) it got dropped       
+bool LogQueue::Push(Kind kind, ::std::string_view text, Kernels::RGB8 color, uint8_t style) noexcept {
+   const auto producer = CurrentProducer();
+   do {
+      const auto size = static_cast<uint16_t>(::std::min<size_t>(text.size(), InlineText));
+
+      // Claim a cell                                                   
+      Cell* cell;
+      auto position = mTail.load(::std::memory_order_relaxed);
+      while (true) {
+         cell = &mCells[position & mMask];
+         const auto sequence = cell->mSequence.load(::std::memory_order_acquire);
+         const auto difference = static_cast<int64_t>(sequence - position);
+         if (difference == 0) {
+            if (mTail.compare_exchange_weak(position, position + 1, ::std::memory_order_relaxed))
+               break;
+         }
+         else if (difference < 0) {
+            // Full - the consumer didn't free this cell yet            
+            mDropped.fetch_add(1, ::std::memory_order_relaxed);
+            return false;
+         }
+         else position = mTail.load(::std::memory_order_relaxed);
+      }
+
+      auto& fragment = cell->mFragment;
+      fragment.mProducer = producer;
+      fragment.mKind = kind;
+      fragment.mStyle = style;
+      fragment.mSize = size;
+      fragment.mColor = color;
+      if (size)
+         ::std::memcpy(fragment.mText, text.data(), size);
+      cell->mSequence.store(position + 1, ::std::memory_order_release);
+      mPushed.fetch_add(1, ::std::memory_order_relaxed);
+
+      text.remove_prefix(size);
+   } while (not text.empty());
+
+   if (not mSignal.load(::std::memory_order_relaxed))
+      mSignal.store(true, ::std::memory_order_release);
+   return true;
+}
+
+/// Find the line being assembled for a producer                              
+/// If all lines are taken, the least recently used one is flushed            
+///   @param producer - the producer                                          
+///   @param log - where to flush lines                                       
+///   @return the line                                                        
+auto LogQueue::FindPending(uint32_t producer, LogRing& log) -> Pending& {
+   Pending* oldest = &mPending[0];
+   for (auto& pending : mPending) {
+      if (pending.mUsed and pending.mProducer == producer) {
+         pending.mLastUse = ++mUses;
+         return pending;
+      }
+      if (not pending.mUsed or (oldest->mUsed and pending.mLastUse < oldest->mLastUse))
+         oldest = &pending;
+   }
+
+   if (oldest->mUsed and not oldest->mText.empty())
+      log.Push(oldest->mText, oldest->mColor, oldest->mStyle);
+
+   oldest->mProducer = producer;
+   oldest->mUsed = true;
+   oldest->mLastUse = ++mUses;
+   oldest->mText.clear();
+   oldest->mColor = DefaultColor;
+   oldest->mStyle = {};
+   return *oldest;
+}
+
+/// Move fragments to a log - only one thread may drain at a time             
+///   @param log - the log to assemble lines in                               
+///   @param max - most fragments to drain at once                            
+///   @return the number of drained fragments                                 
+auto LogQueue::Drain(LogRing& log, uint32_t max) -> uint32_t {
+   uint32_t drained = 0;
+   for (; drained < max; ++drained) {
+      auto& cell = mCells[mHead & mMask];
+      if (cell.mSequence.load(::std::memory_order_acquire) != mHead + 1)
+         break;
+
+      const auto& fragment = cell.mFragment;
+      auto& line = FindPending(fragment.mProducer, log);
+      switch (fragment.mKind) {
+      case Text:
+         line.mText.append(fragment.mText, fragment.mSize);
+         break;
+      case Style:
+         // A new style on a line that already has text applies to      
+         // the whole line - lines have a single style                  
+         line.mColor = fragment.mColor;
+         line.mStyle = fragment.mStyle;
+         break;
+      case NewLine:
+         log.Push(line.mText, line.mColor, line.mStyle);
+         line.mText.clear();
+         break;
+      case Clear:
+         log.Clear();
+         break;
+      }
+
+      cell.mSequence.store(mHead + mMask + 1, ::std::memory_order_release);
+      ++mHead;
+   }
+
+   mPeakBatch = ::std::max(mPeakBatch, drained);
+   return drained;
+}
+
+/// Get the queue statistics                                                  
+///   @return the statistics                                                  
+auto LogQueue::GetStats() const noexcept -> Stats {
+   return {
+      mPushed.load(::std::memory_order_relaxed),
+      mDropped.load(::std::memory_order_relaxed),
+      mPeakBatch
+   };
+}
@@ -0,0 +1,105 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "LogRing.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+
+
+///                                                                           
+///   Lock-free log queue                                                     
+///                                                                           
+///   Carries log fragments from any number of threads to a single consumer.  
+/// It is a bounded ring of fixed-size cells, each with its own sequence      
+/// number, so producers only ever contend on a single atomic increment, and  
+/// never wait - when the consumer falls behind and the ring is full, the     
+/// fragment is dropped, and counted. Fragments of different threads can      
+/// interleave, so the consumer assembles lines separately for each thread.   
+///                                                                           
+class LogQueue {
+public:
+   /// Kinds of fragments                                                     
+   enum Kind : uint8_t {
+      Text,       // Text to append to the current line
+      Style,      // Color and style for the text that follows
+      NewLine,    // End of the current line
+      Clear       // Clear the whole log
+   };
+
+   /// Statistics, for detecting producers outrunning the consumer            
+   struct Stats {
+      // Fragments that made it into the queue                          
+      uint64_t mPushed {};
+      // Fragments dropped, because the queue was full                  
+      uint64_t mDropped {};
+      // Most fragments drained at once                                 
+      uint32_t mPeakBatch {};
+   };
+
+   static constexpr uint32_t InlineText = 108;
+   static constexpr Kernels::RGB8 DefaultColor = Kernels::Pack(204, 204, 204);
+
+   explicit LogQueue(uint32_t capacity);
+
+   static auto CurrentProducer() noexcept -> uint32_t;
+
+   bool Push(Kind, ::std::string_view = {}, Kernels::RGB8 = 0, uint8_t style = 0) noexcept;
+   auto Drain(LogRing&, uint32_t max) -> uint32_t;
+   auto GetStats() const noexcept -> Stats;
+
+   /// Check if anything was pushed since the last check                      
+   ///   @return true if there's something to drain                           
+   bool TakeSignal() noexcept {
+      return mSignal.exchange(false, ::std::memory_order_acquire);
+   }
+
+private:
+   /// A fragment, small enough to never need an allocation                   
+   struct Fragment {
+      uint32_t mProducer;
+      Kind mKind;
+      uint8_t mStyle;
+      uint16_t mSize;
+      Kernels::RGB8 mColor;
+      char mText[InlineText];
+   };
+
+   /// A cell of the ring - the sequence tells whose turn it is               
+   struct alignas(64) Cell {
+      ::std::atomic<uint64_t> mSequence;
+      Fragment mFragment;
+   };
+
+   /// A line being assembled for one of the producers                        
+   struct Pending {
+      uint32_t mProducer {};
+      bool mUsed {};
+      uint64_t mLastUse {};
+      ::std::string mText;
+      Kernels::RGB8 mColor = DefaultColor;
+      uint8_t mStyle {};
+   };
+
+   auto FindPending(uint32_t, LogRing&) -> Pending&;
+
+   ::std::unique_ptr<Cell[]> mCells;
+   uint64_t mMask;
+   alignas(64) ::std::atomic<uint64_t> mTail {0};
+   ::std::atomic<uint64_t> mPushed {0};
+   ::std::atomic<uint64_t> mDropped {0};
+   // Raised by producers, so the consumer can be woken up without      
+   // draining - checked with a plain load first, to avoid contention   
+   ::std::atomic<bool> mSignal {false};
+
+   // Owned by the consumer                                             
+   alignas(64) uint64_t mHead = 0;
+   uint32_t mPeakBatch = 0;
+   Pending mPending[8];
+   uint64_t mUses = 0;
+};
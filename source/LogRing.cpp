@@ -0,0 +1,69 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "LogRing.hpp"
+#include <algorithm>
+#include <cstring>
+
+
+/// Create a log                                                              
+///   @param lines - most lines the log keeps                                 
+///   @param bytes - most bytes of text the log keeps - longer lines are      
+///                  truncated to a quarter of it                             
+LogRing::LogRing(uint32_t lines, uint32_t bytes)
+   : mRecords {::std::make_unique<Record[]>(::std::max(lines, 1u))}
+   , mText {::std::make_unique<char[]>(::std::max(bytes, 4u))}
+   , mCapacity {::std::max(lines, 1u)}
+   , mBytes {::std::max(bytes, 4u)} {}
+
+/// Add a line, dropping the oldest lines if there's no room for it           
+///   @param text - the line                                                  
+///   @param color - color of the text                                        
+///   @param style - style bits of the text                                   
+void LogRing::Push(::std::string_view text, Kernels::RGB8 color, uint8_t style) noexcept {
+   const auto size = static_cast<uint32_t>(::std::min<size_t>(text.size(), mBytes / 4));
+
+   // Text must be contiguous, so skip the end of the buffer, if the    
+   // line doesn't fit there                                            
+   auto begin = mWrite;
+   const auto offset = begin % mBytes;
+   if (offset + size > mBytes)
+      begin += mBytes - offset;
+
+   // Drop lines whose text would be overwritten, or to make room for   
+   // another record                                                    
+   while (mCount and (mCount == mCapacity
+   or mRecords[mFirst].mBegin + mBytes < begin + size)) {
+      mFirst = (mFirst + 1) % mCapacity;
+      --mCount;
+   }
+
+   if (size)
+      ::std::memcpy(mText.get() + begin % mBytes, text.data(), size);
+
+   mRecords[(mFirst + mCount) % mCapacity] = {begin, size, color, style};
+   ++mCount;
+   ++mPushed;
+   mWrite = begin + size;
+}
+
+/// Remove all lines                                                          
+void LogRing::Clear() noexcept {
+   mFirst = 0;
+   mCount = 0;
+}
+
+/// Get a line                                                                
+///   @param index - index of the line, zero being the oldest one             
+///   @return the line, valid until the next Push                             
+auto LogRing::Get(uint32_t index) const noexcept -> Line {
+   const auto& record = mRecords[(mFirst + index) % mCapacity];
+   return {
+      {mText.get() + record.mBegin % mBytes, record.mSize},
+      record.mColor, record.mStyle
+   };
+}
@@ -0,0 +1,68 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Kernels.hpp"
+#include <memory>
+#include <string_view>
+
+
+///                                                                           
+///   Bounded log                                                             
+///                                                                           
+///   Keeps the most recent log lines in fixed-capacity ring buffers - one    
+/// for compact line records, and one for their text - so memory never grows, 
+/// no matter how much gets logged, and nothing is allocated after creation.  
+/// The oldest lines are dropped, once either buffer is full. A line's text   
+/// is always contiguous, so it can be viewed without copying.                
+///                                                                           
+class LogRing {
+public:
+   /// A line, as viewed from the log                                         
+   struct Line {
+      ::std::string_view mText;
+      Kernels::RGB8 mColor;
+      uint8_t mStyle;
+   };
+
+   LogRing(uint32_t lines, uint32_t bytes);
+
+   void Push(::std::string_view, Kernels::RGB8, uint8_t style = 0) noexcept;
+   void Clear() noexcept;
+   auto Get(uint32_t) const noexcept -> Line;
+
+   /// Get the number of lines in the log                                     
+   uint32_t GetCount() const noexcept {
+      return mCount;
+   }
+
+   /// Get the number of lines ever pushed, including dropped ones            
+   uint64_t GetPushed() const noexcept {
+      return mPushed;
+   }
+
+private:
+   /// A line, as stored in the log - its text is at mBegin in a stream of    
+   /// all text ever pushed, wrapped around the text buffer                   
+   struct Record {
+      uint64_t mBegin;
+      uint32_t mSize;
+      Kernels::RGB8 mColor;
+      uint8_t mStyle;
+   };
+
+   ::std::unique_ptr<Record[]> mRecords;
+   ::std::unique_ptr<char[]> mText;
+   uint32_t mCapacity;
+   uint32_t mBytes;
+   // Index of the oldest record, and the number of records             
+   uint32_t mFirst = 0;
+   uint32_t mCount = 0;
+   // Where the next line's text goes, in the stream of all text        
+   uint64_t mWrite = 0;
+   uint64_t mPushed = 0;
+};
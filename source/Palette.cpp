@@ -0,0 +1,202 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Palette.hpp"
+#include <array>
+#include <memory>
+
+using namespace Kernels;
+
+
+/// The 16 system colors, as xterm displays them by default                   
+constexpr RGB8 SystemColors[16] {
+   Pack(  0,   0,   0), Pack(205,   0,   0), Pack(  0, 205,   0), Pack(205, 205,   0),
+   Pack(  0,   0, 238), Pack(205,   0, 205), Pack(  0, 205, 205), Pack(229, 229, 229),
+   Pack(127, 127, 127), Pack(255,   0,   0), Pack(  0, 255,   0), Pack(255, 255,   0),
+   Pack( 92,  92, 255), Pack(255,   0, 255), Pack(  0, 255, 255), Pack(255, 255, 255)
+};
+
+/// Component levels of the xterm 6x6x6 color cube                            
+constexpr uint8_t CubeLevels[6] {0, 95, 135, 175, 215, 255};
+
+/// 4x4 Bayer matrix                                                          
+constexpr uint8_t Bayer[4][4] {
+   { 0,  8,  2, 10},
+   {12,  4, 14,  6},
+   { 3, 11,  1,  9},
+   {15,  7, 13,  5}
+};
+
+/// Get the color of an xterm palette entry                                   
+///   @param index - the entry                                                
+///   @return the color                                                       
+constexpr RGB8 PaletteColor(uint8_t index) noexcept {
+   if (index < 16)
+      return SystemColors[index];
+   if (index >= 232) {
+      const uint32_t grey = 8 + (index - 232) * 10;
+      return Pack(grey, grey, grey);
+   }
+
+   const uint32_t i = index - 16;
+   return Pack(CubeLevels[i / 36], CubeLevels[i / 6 % 6], CubeLevels[i % 6]);
+}
+
+/// Perceptually weighted distance between two colors                         
+///   @param a, b - the colors                                                
+///   @return the squared distance                                            
+constexpr uint32_t Distance(RGB8 a, RGB8 b) noexcept {
+   const int dr = Red(a) - Red(b);
+   const int dg = Green(a) - Green(b);
+   const int db = Blue(a) - Blue(b);
+   return static_cast<uint32_t>(2 * dr * dr + 4 * dg * dg + 3 * db * db);
+}
+
+/// Build the lookup table of a palette                                       
+///   @param depth - the palette                                              
+///   @return the table, each cell mapped by its center                       
+auto BuildTable(ColorDepth depth) {
+   constexpr auto L = Palette::Levels;
+   constexpr auto Shift = 8 - Palette::LevelBits;
+   auto table = ::std::make_unique<::std::array<uint8_t, L * L * L>>();
+   for (uint32_t b = 0; b < L; ++b) {
+      for (uint32_t g = 0; g < L; ++g) {
+         for (uint32_t r = 0; r < L; ++r) {
+            const auto center = Pack(
+               (r << Shift) | (1 << (Shift - 1)),
+               (g << Shift) | (1 << (Shift - 1)),
+               (b << Shift) | (1 << (Shift - 1))
+            );
+            (*table)[r + L * (g + L * b)] = Palette::Nearest(depth, center);
+         }
+      }
+   }
+   return table;
+}
+
+/// Get the shared lookup table of a palette, building it on first use        
+///   @param depth - the palette                                              
+///   @return the table                                                       
+const uint8_t* GetTable(ColorDepth depth) {
+   switch (depth) {
+   case ColorDepth::Colors256: {
+      static const auto table = BuildTable(depth);
+      return table->data();
+   }
+   case ColorDepth::Colors16: {
+      static const auto table = BuildTable(depth);
+      return table->data();
+   }
+   default:
+      return nullptr;
+   }
+}
+
+
+/// Create a quantizer                                                        
+///   @param depth - the colors the terminal can display                      
+///   @param dither - whether to apply an ordered dither                      
+Palette::Palette(ColorDepth depth, bool dither)
+   : mDepth  {depth}
+   , mDither {dither and depth != ColorDepth::TrueColor}
+   , mTable  {GetTable(depth)} {
+   switch (depth) {
+   case ColorDepth::Colors256:
+      mFlag = Indexed256;
+      break;
+   case ColorDepth::Colors16:
+      mFlag = Indexed16;
+      break;
+   default:
+      break;
+   }
+
+   if (not mDither)
+      return;
+
+   // Spread the thresholds over about one step between palette colors  
+   const int spread = depth == ColorDepth::Colors256 ? 40 : 96;
+   for (int y = 0; y < 4; ++y)
+      for (int x = 0; x < 4; ++x)
+         mThresholds[y][x] = static_cast<int8_t>((Bayer[y][x] * 2 - 15) * spread / 32);
+}
+
+/// Quantize a row of colors in place                                         
+/// Does nothing for truecolor                                                
+///   @param colors - the packed truecolors, replaced with palette entries    
+///   @param count - number of colors in the row                              
+///   @param y - index of the row, selects the dither thresholds              
+void Palette::Quantize(RGB8* colors, uint32_t count, uint32_t y) const noexcept {
+   if (not mTable)
+      return;
+
+   constexpr auto L = Levels;
+   constexpr auto Shift = 8 - LevelBits;
+   if (not mDither) {
+      for (uint32_t x = 0; x < count; ++x) {
+         const auto c = colors[x];
+         colors[x] = mFlag | mTable[
+             (Red(c) >> Shift)
+          + ((Green(c) >> Shift) << LevelBits)
+          + ((Blue(c) >> Shift) << (LevelBits * 2))
+         ];
+      }
+      return;
+   }
+
+   const auto thresholds = mThresholds[y % 4];
+   const auto level = [](int c) noexcept {
+      c = c < 0 ? 0 : c > 255 ? 255 : c;
+      return static_cast<uint32_t>(c) >> Shift;
+   };
+
+   for (uint32_t x = 0; x < count; ++x) {
+      const auto c = colors[x];
+      const int t = thresholds[x % 4];
+      colors[x] = mFlag | mTable[
+           level(Red(c) + t)
+         + level(Green(c) + t) * L
+         + level(Blue(c) + t) * L * L
+      ];
+   }
+}
+
+/// Get a value that changes whenever quantization settings change, for       
+/// mixing into hashes of quantized content                                   
+///   @return the seed                                                        
+auto Palette::GetSeed() const noexcept -> uint64_t {
+   return static_cast<uint64_t>(mDepth) | (static_cast<uint64_t>(mDither) << 8);
+}
+
+/// Get the truecolor a packed color is displayed as                          
+///   @param c - the packed color, either truecolor or a palette entry        
+///   @return the truecolor, as xterm displays it by default                  
+auto Palette::GetColor(RGB8 c) noexcept -> RGB8 {
+   return PaletteOf(c) ? PaletteColor(Index(c)) : c;
+}
+
+/// Find the closest palette entry to a color, by exhaustive search           
+/// Used to build the lookup tables                                           
+///   @param depth - the palette                                              
+///   @param c - the color                                                    
+///   @return the index of the closest entry                                  
+auto Palette::Nearest(ColorDepth depth, RGB8 c) noexcept -> uint8_t {
+   // The system colors of a 256 color palette are often customized by  
+   // the user, so only the cube and the greys are reliable             
+   const uint32_t first = depth == ColorDepth::Colors16 ? 0 : 16;
+   const uint32_t last  = depth == ColorDepth::Colors16 ? 16 : 256;
+   uint32_t best = first;
+   uint32_t bestDistance = UINT32_MAX;
+   for (uint32_t i = first; i < last; ++i) {
+      const auto d = Distance(c, PaletteColor(static_cast<uint8_t>(i)));
+      if (d < bestDistance) {
+         best = i;
+         bestDistance = d;
+      }
+   }
+   return static_cast<uint8_t>(best);
+}
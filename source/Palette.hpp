@@ -0,0 +1,63 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Kernels.hpp"
+
+
+/// Colors a terminal can display                                             
+enum class ColorDepth : uint8_t {
+   TrueColor,
+   Colors256,
+   Colors16
+};
+
+
+///                                                                           
+///   Palette quantizer                                                       
+///                                                                           
+///   Maps packed truecolors to the closest entries of an xterm palette. The  
+/// closest entry is never searched per cell - a lookup table, indexed by the 
+/// five highest bits of each component, is built once per palette, and is    
+/// shared by all quantizers. An optional 4x4 ordered dither trades spatial   
+/// resolution for gradients, without any state carried between cells, so     
+/// rows can still be quantized independently and in any order.               
+///                                                                           
+class Palette {
+public:
+   static constexpr uint32_t LevelBits = 5;
+   static constexpr uint32_t Levels = 1 << LevelBits;
+
+   Palette(ColorDepth = ColorDepth::TrueColor, bool dither = false);
+
+   void Quantize(Kernels::RGB8*, uint32_t, uint32_t y) const noexcept;
+   auto GetSeed() const noexcept -> uint64_t;
+
+   /// Get the color depth                                                    
+   ColorDepth GetDepth() const noexcept {
+      return mDepth;
+   }
+
+   /// Check if quantized colors are dithered                                 
+   bool IsDithered() const noexcept {
+      return mDither;
+   }
+
+   static auto GetColor(Kernels::RGB8) noexcept -> Kernels::RGB8;
+   static auto Nearest(ColorDepth, Kernels::RGB8) noexcept -> uint8_t;
+
+private:
+   ColorDepth mDepth;
+   bool mDither;
+   // Shared lookup table, Levels^3 palette indices, red being the      
+   // fastest changing coordinate; nullptr for truecolor                
+   const uint8_t* mTable = nullptr;
+   // Marks quantized colors with the palette they belong to            
+   Kernels::RGB8 mFlag = 0;
+   // Ordered dither offsets, already scaled to the palette             
+   int8_t mThresholds[4][4] {};
+};
@@ -0,0 +1,263 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "SearchIndex.hpp"
+#include <algorithm>
+
+
+/// Lowercase ASCII text into a buffer                                        
+///   @param text - the text                                                  
+///   @param out - [out] the lowercase text                                   
+static void Lowercase(::std::string_view text, ::std::string& out) {
+   out.resize(text.size());
+   ::std::transform(text.begin(), text.end(), out.begin(), [](char c) {
+      return (c >= 'A' and c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+   });
+}
+
+/// Pack one to three characters in an n-gram, along with their count         
+///   @param text - the characters                                            
+///   @param n - the number of characters                                     
+///   @return the n-gram                                                      
+static uint32_t Gram(const char* text, size_t n) noexcept {
+   uint32_t gram = static_cast<uint32_t>(n) << 24;
+   for (size_t i = 0; i < n; ++i)
+      gram |= static_cast<uint32_t>(static_cast<uint8_t>(text[i])) << (i * 8);
+   return gram;
+}
+
+/// Begin a reconciliation pass - every object that still exists has to be    
+/// touched, before sweeping away those that weren't                          
+void SearchIndex::Begin() noexcept {
+   ++mGeneration;
+}
+
+/// Get the identifier of a term, indexing it if it's new                     
+///   @param text - the term                                                  
+///   @return the term identifier                                             
+auto SearchIndex::Intern(::std::string_view text) -> uint32_t {
+   const auto found = mTermIds.find(text);
+   if (found != mTermIds.end())
+      return found->second;
+
+   const auto id = static_cast<uint32_t>(mTerms.size());
+   Lowercase(text, mLower);
+   mTerms.push_back({::std::string {text}, mLower, {}});
+   mTermIds.emplace(::std::string {text}, id);
+   for (size_t n = 1; n <= 3; ++n) {
+      for (size_t i = 0; i + n <= mLower.size(); ++i) {
+         auto& terms = mGrams[Gram(mLower.data() + i, n)];
+         // Repeated n-grams in the same term are indexed once          
+         if (terms.empty() or terms.back() != id)
+            terms.push_back(id);
+      }
+   }
+   return id;
+}
+
+/// Attach an entry to a term                                                 
+///   @param entry - the entry                                                
+///   @param term - the term                                                  
+void SearchIndex::Link(uint32_t entry, uint32_t term) {
+   auto& entries = mTerms[term].mEntries;
+   mEntries[entry].mTerm = term;
+   mEntries[entry].mSlot = static_cast<uint32_t>(entries.size());
+   entries.push_back(entry);
+}
+
+/// Detach an entry from its term, releasing the term if it was the last     
+///   @param entry - the entry                                                
+void SearchIndex::Unlink(uint32_t entry) {
+   const auto term = mEntries[entry].mTerm;
+   auto& entries = mTerms[term].mEntries;
+   const auto slot = mEntries[entry].mSlot;
+   entries[slot] = entries.back();
+   mEntries[entries[slot]].mSlot = slot;
+   entries.pop_back();
+   if (entries.empty())
+      Release(term);
+}
+
+/// Release a term that no entry has anymore                                  
+/// Its text is freed right away, but it stays in the n-gram lists, where     
+/// queries skip it, until enough terms are released to compact them all      
+///   @param term - the term                                                  
+void SearchIndex::Release(uint32_t term) {
+   auto& released = mTerms[term];
+   mTermIds.erase(mTermIds.find(::std::string_view {released.mText}));
+   released.mText = {};
+   released.mLower = {};
+   released.mEntries = {};
+
+   ++mDeadTerms;
+   if (mDeadTerms > 64 and mDeadTerms * 2 > mTerms.size())
+      Compact();
+}
+
+/// Remove released terms, renumbering the rest in the same order, so the     
+/// n-gram lists stay ascending                                               
+void SearchIndex::Compact() {
+   constexpr auto Dead = ~uint32_t {0};
+   ::std::vector<uint32_t> remap(mTerms.size(), Dead);
+   uint32_t live = 0;
+   for (uint32_t id = 0; id < mTerms.size(); ++id) {
+      if (mTerms[id].mEntries.empty())
+         continue;
+      if (live != id)
+         mTerms[live] = ::std::move(mTerms[id]);
+      remap[id] = live++;
+   }
+   mTerms.resize(live);
+
+   for (auto& [text, id] : mTermIds)
+      id = remap[id];
+   for (auto& [key, entry] : mKeys)
+      mEntries[entry].mTerm = remap[mEntries[entry].mTerm];
+
+   for (auto it = mGrams.begin(); it != mGrams.end();) {
+      auto& terms = it->second;
+      size_t kept = 0;
+      for (auto id : terms) {
+         if (remap[id] != Dead)
+            terms[kept++] = remap[id];
+      }
+
+      if (kept == 0)
+         it = mGrams.erase(it);
+      else {
+         terms.resize(kept);
+         ++it;
+      }
+   }
+   mDeadTerms = 0;
+}
+
+/// Mark an object as existing, indexing or updating it if it changed         
+///   @param key - the object                                                 
+///   @param parent - the object it belongs to                                
+///   @param term - the searchable term                                       
+///   @param kind - kind of the object, up to the user                        
+void SearchIndex::Touch(Key key, Key parent, ::std::string_view term, uint8_t kind) {
+   const auto found = mKeys.find(key);
+   if (found != mKeys.end()) {
+      auto& entry = mEntries[found->second];
+      entry.mParent = parent;
+      entry.mKind = kind;
+      entry.mGeneration = mGeneration;
+      if (mTerms[entry.mTerm].mText != term) {
+         // Renamed - the old term might get released, and ids          
+         // compacted, so intern the new one only after that            
+         Unlink(found->second);
+         Link(found->second, Intern(term));
+      }
+      return;
+   }
+
+   uint32_t index;
+   if (not mFree.empty()) {
+      index = mFree.back();
+      mFree.pop_back();
+   }
+   else {
+      index = static_cast<uint32_t>(mEntries.size());
+      mEntries.emplace_back();
+   }
+
+   auto& entry = mEntries[index];
+   entry.mKey = key;
+   entry.mParent = parent;
+   entry.mKind = kind;
+   entry.mGeneration = mGeneration;
+   Link(index, Intern(term));
+   mKeys.emplace(key, index);
+}
+
+/// Remove an object, releasing its term if no other object has it           
+///   @param key - the object                                                 
+///   @return true if the object was indexed                                  
+bool SearchIndex::Remove(Key key) {
+   const auto found = mKeys.find(key);
+   if (found == mKeys.end())
+      return false;
+
+   Unlink(found->second);
+   mEntries[found->second] = {};
+   mFree.push_back(found->second);
+   mKeys.erase(found);
+   return true;
+}
+
+/// End a reconciliation pass, removing objects that weren't touched          
+///   @return the number of removed objects                                   
+auto SearchIndex::Sweep() -> uint32_t {
+   uint32_t removed = 0;
+   for (auto it = mKeys.begin(); it != mKeys.end();) {
+      if (mEntries[it->second].mGeneration == mGeneration) {
+         ++it;
+         continue;
+      }
+
+      Unlink(it->second);
+      mEntries[it->second] = {};
+      mFree.push_back(it->second);
+      it = mKeys.erase(it);
+      ++removed;
+   }
+   return removed;
+}
+
+/// Find the entry of an object                                               
+///   @param key - the object                                                 
+///   @return the entry, or nullptr if the object isn't indexed               
+auto SearchIndex::FindEntry(Key key) const noexcept -> const Entry* {
+   const auto found = mKeys.find(key);
+   return found == mKeys.end() ? nullptr : &mEntries[found->second];
+}
+
+/// Find all objects whose term contains the query, ignoring case             
+///   @param query - the text to look for                                     
+///   @param out - [out] the matching entries, up to max of them              
+///   @param max - the most entries to collect                                
+///   @return the number of matching entries, even if more than max           
+auto SearchIndex::Find(::std::string_view query, ::std::vector<uint32_t>& out, uint32_t max) const -> uint32_t {
+   out.clear();
+   ::std::string lower;
+   Lowercase(query, lower);
+
+   if (lower.empty())
+      return 0;
+
+   // Every match contains all trigrams of the query, so only the terms 
+   // with its rarest trigram are candidates - short queries are        
+   // n-grams themselves, and need no verification at all               
+   const auto n = ::std::min<size_t>(lower.size(), 3);
+   const ::std::vector<uint32_t>* rarest = nullptr;
+   for (size_t i = 0; i + n <= lower.size(); ++i) {
+      const auto found = mGrams.find(Gram(lower.data() + i, n));
+      if (found == mGrams.end())
+         return 0;
+      if (not rarest or found->second.size() < rarest->size())
+         rarest = &found->second;
+   }
+
+   uint32_t total = 0;
+   const bool verify = lower.size() > 3;
+   for (auto id : *rarest) {
+      const auto& term = mTerms[id];
+      if (term.mEntries.empty()
+      or (verify and term.mLower.find(lower) == ::std::string::npos))
+         continue;
+
+      total += static_cast<uint32_t>(term.mEntries.size());
+      for (auto entry : term.mEntries) {
+         if (out.size() >= max)
+            break;
+         out.push_back(entry);
+      }
+   }
+   return total;
+}
@@ -0,0 +1,124 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+///                                                                           
+///   Hierarchy search index                                                  
+///                                                                           
+///   Indexes objects of some external hierarchy by a searchable term - a     
+/// name, or a type token - for case-insensitive substring queries. Equal     
+/// terms are stored once, and every distinct term is indexed by all of its   
+/// substrings of up to three characters, so short queries are answered       
+/// directly from a single list, and longer ones only verify the terms that   
+/// contain their rarest trigram - objects are never scanned. The index is    
+/// kept in sync either by removing and touching the objects that changed,    
+/// or by reconciliation passes. Terms that are left without objects are      
+/// released, and their ids compacted once they pile up, so the index only    
+/// ever holds what currently exists.                                         
+///                                                                           
+class SearchIndex {
+public:
+   /// Identifies the external object an entry represents                     
+   using Key = const void*;
+
+   /// An indexed object                                                      
+   struct Entry {
+      Key mKey {};
+      // The object this one belongs to, if any                         
+      Key mParent {};
+      uint32_t mTerm {};
+      // Position among the entries of the term                         
+      uint32_t mSlot {};
+      // Pass in which the object was last seen                         
+      uint32_t mGeneration {};
+      // What kind of object the key is, up to the user                 
+      uint8_t mKind {};
+   };
+
+   void Begin() noexcept;
+   void Touch(Key, Key, ::std::string_view, uint8_t);
+   bool Remove(Key);
+   auto Sweep() -> uint32_t;
+   auto Find(::std::string_view, ::std::vector<uint32_t>&, uint32_t max) const -> uint32_t;
+   auto FindEntry(Key) const noexcept -> const Entry*;
+
+   /// Get an entry                                                           
+   ///   @param entry - index of the entry                                    
+   ///   @return the entry                                                    
+   const Entry& Get(uint32_t entry) const noexcept {
+      return mEntries[entry];
+   }
+
+   /// Get the term of an entry                                               
+   ///   @param entry - index of the entry                                    
+   ///   @return the term                                                     
+   ::std::string_view GetTerm(uint32_t entry) const noexcept {
+      return GetTerm(mEntries[entry]);
+   }
+
+   /// Get the term of an entry                                               
+   ///   @param entry - the entry                                             
+   ///   @return the term                                                     
+   ::std::string_view GetTerm(const Entry& entry) const noexcept {
+      return mTerms[entry.mTerm].mText;
+   }
+
+   /// Get the number of indexed objects                                      
+   uint32_t GetCount() const noexcept {
+      return static_cast<uint32_t>(mKeys.size());
+   }
+
+   /// Get the number of distinct terms of the indexed objects                
+   uint32_t GetTermCount() const noexcept {
+      return static_cast<uint32_t>(mTerms.size()) - mDeadTerms;
+   }
+
+private:
+   /// A distinct term, and the entries that have it                          
+   struct Term {
+      ::std::string mText;
+      ::std::string mLower;
+      ::std::vector<uint32_t> mEntries;
+   };
+
+   /// Allows looking terms up by views, without making strings               
+   struct TermHash {
+      using is_transparent = void;
+      size_t operator () (::std::string_view text) const noexcept {
+         return ::std::hash<::std::string_view> {}(text);
+      }
+   };
+
+   auto Intern(::std::string_view) -> uint32_t;
+   void Link(uint32_t, uint32_t);
+   void Unlink(uint32_t);
+   void Release(uint32_t);
+   void Compact();
+
+   ::std::vector<Entry> mEntries;
+   // Released entries, waiting to be recycled                          
+   ::std::vector<uint32_t> mFree;
+   ::std::unordered_map<Key, uint32_t> mKeys;
+
+   ::std::vector<Term> mTerms;
+   ::std::unordered_map<::std::string, uint32_t, TermHash, ::std::equal_to<>> mTermIds;
+   // Terms that contain each n-gram, in ascending order                
+   ::std::unordered_map<uint32_t, ::std::vector<uint32_t>> mGrams;
+   // Released terms, still listed in mGrams until compacted            
+   uint32_t mDeadTerms = 0;
+
+   uint32_t mGeneration = 0;
+   // Scratch space for lowercasing                                     
+   ::std::string mLower;
+};
@@ -0,0 +1,77 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include <Langulus/UI.hpp>
+
+using namespace Langulus;
+
+/// Traits for configuring GUI systems via their descriptors                  
+/// Kept apart from FTXUI, so that tests and tools can use them, too          
+LANGULUS_DEFINE_TRAIT(Threaded,
+   "Whether a GUI system runs its terminal loop on a dedicated thread");
+LANGULUS_DEFINE_TRAIT(Colors,
+   "Number of colors a GUI system quantizes to - 256, 16, or 0 for truecolor");
+LANGULUS_DEFINE_TRAIT(Dither,
+   "Whether a GUI system dithers colors it quantizes to a palette");
+LANGULUS_DEFINE_TRAIT(Headless,
+   "Whether a GUI system renders to memory, instead of a terminal");
+LANGULUS_DEFINE_TRAIT(KeepAlive,
+   "Longest time a GUI system stays idle, before running its loop anyway");
+LANGULUS_DEFINE_TRAIT(HalfBlocks,
+   "Whether a GUI system draws color-only images with two pixels per cell");
+LANGULUS_DEFINE_TRAIT(Editor,
+   "Whether a GUI system shows the editor - log, flow console, and stats");
+
+/// Traits for configuring GUI items via their descriptors                    
+LANGULUS_DEFINE_TRAIT(Widget,
+   "Kind of widget a GUI item is - label, gauge, or table");
+LANGULUS_DEFINE_TRAIT(Caption,
+   "Text of a GUI item - table rows are separated by new lines, and columns by tabs");
+LANGULUS_DEFINE_TRAIT(Progress,
+   "Progress a gauge GUI item displays, from zero to one");
+
+/// Traits for querying the statistics of GUI systems via Verbs::Select       
+/// Timings are in nanoseconds, and distributions are answered as the median, 
+/// the 99th percentile, and the maximum of the recent frames                 
+LANGULUS_DEFINE_TRAIT(ConvertTime,
+   "Time a GUI system spends converting an image to cells");
+LANGULUS_DEFINE_TRAIT(LayoutTime,
+   "Time a GUI system spends laying out and rendering its components");
+LANGULUS_DEFINE_TRAIT(WriteTime,
+   "Time a GUI system spends writing a frame to the terminal");
+LANGULUS_DEFINE_TRAIT(CellsChanged,
+   "Number of cells a GUI system converts per frame");
+LANGULUS_DEFINE_TRAIT(BytesEmitted,
+   "Number of bytes a GUI system writes to the terminal per frame");
+LANGULUS_DEFINE_TRAIT(DroppedFrames,
+   "Number of frames a GUI system drew, but never displayed");
+LANGULUS_DEFINE_TRAIT(InputEvents,
+   "Number of input events a GUI system dispatches per update");
+LANGULUS_DEFINE_TRAIT(Display,
+   "Text a headless GUI system would've written to the terminal on its last update");
+
+/// Traits for searching the hierarchy the editor of a GUI system shows -     
+/// Verbs::Select answers a query with the names and types that match it,     
+/// and Verbs::Associate reveals its first match in the editor's tree         
+LANGULUS_DEFINE_TRAIT(Search,
+   "Query for the hierarchy search of a GUI system's editor");
+
+/// Traits for drawing cells into GUI systems via Verbs::Associate, along     
+/// with Traits::Size in cells - Traits::CellFormat is answered by            
+/// Verbs::Select with the size of frames a system takes natively             
+LANGULUS_DEFINE_TRAIT(CellFormat,
+   "Size of the cell frames a GUI system takes natively");
+LANGULUS_DEFINE_TRAIT(CellGlyphs,
+   "Code points of drawn cells - zero continues a wide grapheme");
+LANGULUS_DEFINE_TRAIT(CellForeground,
+   "Foreground colors of drawn cells, packed in 24 bits, or as RGBA floats");
+LANGULUS_DEFINE_TRAIT(CellBackground,
+   "Background colors of drawn cells, packed in 24 bits, or as RGBA floats");
+LANGULUS_DEFINE_TRAIT(CellStyles,
+   "Style bits of drawn cells - bold, dim, italic, underlined, double "
+   "underlined, blink, inverted, and strikethrough, from the lowest bit");
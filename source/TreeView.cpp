@@ -0,0 +1,218 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "TreeView.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+
+/// Create a tree, with only its root node                                    
+///   @param populator - describes the children of a node, when needed        
+TreeView::TreeView(Populator populator)
+   : mPopulator {::std::move(populator)} {
+   Clear();
+}
+
+/// Release all nodes, and start over from the root                           
+/// The root is expanded, but populated only when rows are first needed       
+void TreeView::Clear() {
+   mNodes.clear();
+   mFree.clear();
+   auto& root = mNodes.emplace_back();
+   root.mExpandable = true;
+   root.mExpanded = true;
+   root.mUsed = true;
+   mRowsDirty = true;
+}
+
+/// Create a node, recycling a released one if possible                       
+///   @param parent - the parent node                                         
+///   @param child - the description of the node                              
+///   @return index of the new node                                           
+auto TreeView::Create(uint32_t parent, const Child& child) -> uint32_t {
+   uint32_t index;
+   if (not mFree.empty()) {
+      index = mFree.back();
+      mFree.pop_back();
+   }
+   else {
+      index = static_cast<uint32_t>(mNodes.size());
+      mNodes.emplace_back();
+   }
+
+   auto& node = mNodes[index];
+   node.mKey = child.mKey;
+   node.mLabel.assign(child.mLabel);
+   node.mKind = child.mKind;
+   node.mParent = parent;
+   node.mDepth = mNodes[parent].mDepth + 1;
+   node.mChildren.clear();
+   node.mExpandable = child.mExpandable;
+   node.mExpanded = false;
+   node.mPopulated = false;
+   node.mUsed = true;
+   return index;
+}
+
+/// Release a node, and all nodes below it                                    
+///   @param index - the node to release                                      
+void TreeView::Release(uint32_t index) {
+   auto& node = mNodes[index];
+   for (auto child : node.mChildren)
+      Release(child);
+   node.mChildren.clear();
+   node.mKey = {};
+   node.mUsed = false;
+   mFree.push_back(index);
+}
+
+/// Reconcile a node's children with their current description                
+/// Children with the same key keep their nodes, with everything below them,  
+/// and their expansion state - only new ones are created, and only missing   
+/// ones are released                                                         
+///   @param index - the node whose children to reconcile                     
+///   @param children - the current children, in display order                
+void TreeView::Sync(uint32_t index, ::std::span<const Child> children) {
+   // Nodes might be recycled below, so work on a copy of the old list  
+   auto previous = ::std::move(mNodes[index].mChildren);
+   ::std::unordered_map<Key, uint32_t> existing;
+   existing.reserve(previous.size());
+   for (auto child : previous) {
+      if (not existing.emplace(mNodes[child].mKey, child).second)
+         Release(child);
+   }
+
+   ::std::vector<uint32_t> result;
+   result.reserve(children.size());
+   bool changed = previous.size() != children.size();
+   for (auto& child : children) {
+      const auto found = existing.find(child.mKey);
+      if (found == existing.end()) {
+         result.push_back(Create(index, child));
+         changed = true;
+         continue;
+      }
+
+      auto& node = mNodes[found->second];
+      if (node.mLabel != child.mLabel)
+         node.mLabel.assign(child.mLabel);
+      if (node.mExpandable != child.mExpandable) {
+         node.mExpandable = child.mExpandable;
+         changed = true;
+      }
+      if (result.size() >= previous.size() or previous[result.size()] != found->second)
+         changed = true;
+      result.push_back(found->second);
+      existing.erase(found);
+   }
+
+   // Whatever remains doesn't exist anymore                            
+   for (auto& [key, child] : existing)
+      Release(child);
+
+   auto& node = mNodes[index];
+   node.mChildren = ::std::move(result);
+   node.mPopulated = true;
+   mRowsDirty |= changed;
+}
+
+/// Expand or collapse a node                                                 
+/// Children are created the first time the node is expanded                  
+///   @param index - the node                                                 
+///   @param expand - true to expand, false to collapse                       
+void TreeView::Expand(uint32_t index, bool expand) {
+   auto& node = mNodes[index];
+   if (not node.mExpandable or node.mExpanded == expand)
+      return;
+
+   node.mExpanded = expand;
+   if (expand and not node.mPopulated)
+      Populate(index);
+   mRowsDirty = true;
+}
+
+/// Expand the tree along a path, populating nodes on the way                 
+///   @param path - keys of the nodes, from a top row down to the node to     
+///                 reveal                                                    
+///   @return the revealed node, or Root if the path doesn't exist            
+auto TreeView::Reveal(::std::span<const Key> path) -> uint32_t {
+   if (not mNodes[Root].mPopulated)
+      Populate(Root);
+
+   uint32_t index = Root;
+   for (auto key : path) {
+      if (index != Root)
+         Expand(index, true);
+
+      const auto& children = mNodes[index].mChildren;
+      const auto found = ::std::find_if(children.begin(), children.end(),
+         [&](uint32_t child) { return mNodes[child].mKey == key; });
+      if (found == children.end())
+         return Root;
+      index = *found;
+   }
+   return index;
+}
+
+/// Have the populator describe a node's children                             
+///   @param index - the node                                                 
+void TreeView::Populate(uint32_t index) {
+   if (mPopulator)
+      mPopulator(*this, index);
+   mNodes[index].mPopulated = true;
+}
+
+/// React to a change in the external hierarchy                               
+/// Expanded nodes are reconciled with their current children, while          
+/// collapsed ones simply forget theirs, to be populated again if expanded -  
+/// so the cost depends on what is expanded, never on the whole hierarchy     
+void TreeView::Refresh() {
+   // Parents precede their children in the rows, so a node released    
+   // or recycled while reconciling its parent is skipped               
+   const auto rows = GetRows();
+   Populate(Root);
+   for (auto index : rows) {
+      auto& node = mNodes[index];
+      if (not node.mUsed or not node.mPopulated)
+         continue;
+
+      if (node.mExpanded)
+         Populate(index);
+      else {
+         for (auto child : node.mChildren)
+            Release(child);
+         node.mChildren.clear();
+         node.mPopulated = false;
+      }
+   }
+   mRowsDirty = true;
+}
+
+/// Get the visible nodes, in display order                                   
+///   @return the nodes                                                       
+auto TreeView::GetRows() -> const ::std::vector<uint32_t>& {
+   if (not mRowsDirty)
+      return mRows;
+
+   if (not mNodes[Root].mPopulated)
+      Populate(Root);
+
+   mRows.clear();
+   Flatten(Root);
+   mRowsDirty = false;
+   return mRows;
+}
+
+/// Append the visible children of a node to the rows                         
+///   @param index - the node                                                 
+void TreeView::Flatten(uint32_t index) {
+   for (auto child : mNodes[index].mChildren) {
+      mRows.push_back(child);
+      if (mNodes[child].mExpanded)
+         Flatten(child);
+   }
+}
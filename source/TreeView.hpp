@@ -0,0 +1,100 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+///                                                                           
+///   Lazy tree view                                                          
+///                                                                           
+///   A tree of labeled nodes, that mirrors some external hierarchy without   
+/// ever walking all of it. A node's children are created only when the node  
+/// is expanded for the first time, by a populator callback, and are kept in  
+/// sync afterwards by reconciling them with the current children, which      
+/// preserves the state of nodes that didn't change. The rows that are        
+/// visible - children of expanded nodes - are flattened on demand, so        
+/// rendering only needs to look at the rows that fit on screen.              
+///                                                                           
+class TreeView {
+public:
+   /// Identifies the external object a node represents                       
+   using Key = const void*;
+
+   /// The invisible root node, whose children are the top rows               
+   static constexpr uint32_t Root = 0;
+
+   /// A node                                                                 
+   struct Node {
+      Key mKey {};
+      ::std::string mLabel;
+      // What kind of object the key is, up to the user                 
+      uint8_t mKind {};
+      uint32_t mParent {};
+      uint32_t mDepth {};
+      ::std::vector<uint32_t> mChildren;
+      bool mExpandable {};
+      bool mExpanded {};
+      // Whether children were created, since the node got expanded     
+      bool mPopulated {};
+      // Whether the slot is used, or waits to be recycled              
+      bool mUsed {};
+   };
+
+   /// A child, as described to Sync                                          
+   struct Child {
+      Key mKey;
+      ::std::string_view mLabel;
+      uint8_t mKind;
+      bool mExpandable;
+   };
+
+   /// Called when a node is expanded for the first time, and when it is      
+   /// refreshed - expected to describe the node's current children to Sync   
+   using Populator = ::std::function<void(TreeView&, uint32_t)>;
+
+   TreeView(Populator);
+
+   void Sync(uint32_t, ::std::span<const Child>);
+   void Expand(uint32_t, bool);
+   auto Reveal(::std::span<const Key>) -> uint32_t;
+   void Refresh();
+   void Clear();
+
+   auto GetRows() -> const ::std::vector<uint32_t>&;
+
+   /// Get a node                                                             
+   ///   @param node - index of the node                                      
+   ///   @return the node                                                     
+   const Node& Get(uint32_t node) const noexcept {
+      return mNodes[node];
+   }
+
+   /// Get the number of nodes that exist, regardless if visible              
+   uint32_t GetNodeCount() const noexcept {
+      return static_cast<uint32_t>(mNodes.size() - mFree.size());
+   }
+
+private:
+   auto Create(uint32_t, const Child&) -> uint32_t;
+   void Release(uint32_t);
+   void Populate(uint32_t);
+   void Flatten(uint32_t);
+
+   Populator mPopulator;
+   ::std::vector<Node> mNodes;
+   // Released nodes, waiting to be recycled                            
+   ::std::vector<uint32_t> mFree;
+   // Visible nodes, in display order                                   
+   ::std::vector<uint32_t> mRows;
+   bool mRowsDirty = true;
+};
@@ -0,0 +1,84 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+
+///                                                                           
+///   Lock-free triple buffer                                                 
+///                                                                           
+///   Hands frames from a single producer to a single consumer, without       
+/// locks, and without either side ever waiting on the other. The producer    
+/// always has a free buffer to write into, and the consumer always picks up  
+/// the latest complete frame - frames that are published before the          
+/// consumer gets to them are dropped. Buffers are recycled, never released,  
+/// so contents from older frames remain in them, and can be reused.          
+///                                                                           
+template<class T>
+class TripleBuffer {
+   static constexpr uint8_t IndexMask = 0b011;
+   static constexpr uint8_t FreshBit  = 0b100;
+
+   T mBuffers[3] {};
+   // Index of the buffer in the middle, and whether it was published   
+   // since the consumer last picked it up                              
+   ::std::atomic<uint8_t> mMiddle {1};
+   // Owned by the producer                                             
+   uint8_t mBack {0};
+   // Owned by the consumer                                             
+   uint8_t mFront {2};
+
+public:
+   /// Get the buffer the producer is allowed to write to                     
+   ///   @return the back buffer                                              
+   T& GetBack() noexcept {
+      return mBuffers[mBack];
+   }
+
+   /// Publish the back buffer, making it the latest complete frame           
+   ///   @return true if the previously published frame was never picked      
+   ///           up by the consumer, and got dropped                          
+   bool Publish() noexcept {
+      const auto old = mMiddle.exchange(mBack | FreshBit, ::std::memory_order_acq_rel);
+      mBack = old & IndexMask;
+      return old & FreshBit;
+   }
+
+   /// Check if there's a published frame the consumer didn't pick up yet     
+   /// Safe to call from both sides                                           
+   ///   @return true if a fresh frame is available                           
+   bool HasFresh() const noexcept {
+      return mMiddle.load(::std::memory_order_acquire) & FreshBit;
+   }
+
+   /// Pick up the latest published frame, if any                             
+   ///   @return true if the front buffer changed                             
+   bool Acquire() noexcept {
+      if (not HasFresh())
+         return false;
+
+      const auto old = mMiddle.exchange(mFront, ::std::memory_order_acq_rel);
+      mFront = old & IndexMask;
+      return true;
+   }
+
+   /// Get the buffer the consumer is allowed to read from                    
+   ///   @return the front buffer                                             
+   T& GetFront() noexcept {
+      return mBuffers[mFront];
+   }
+
+   /// Get any of the buffers, whoever owns it - only while neither side      
+   /// can be using it                                                        
+   ///   @param index - index of the buffer, below three                      
+   ///   @return the buffer                                                   
+   T& GetBuffer(uint8_t index) noexcept {
+      return mBuffers[index];
+   }
+};
@@ -0,0 +1,155 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "WorkPool.hpp"
+#include <algorithm>
+
+
+/// Pack a range of tasks                                                     
+constexpr uint64_t PackRange(uint32_t begin, uint32_t end) noexcept {
+   return begin | (static_cast<uint64_t>(end) << 32);
+}
+
+/// Get the first task of a packed range                                      
+constexpr uint32_t RangeBegin(uint64_t range) noexcept {
+   return static_cast<uint32_t>(range);
+}
+
+/// Get the task after the last one in a packed range                         
+constexpr uint32_t RangeEnd(uint64_t range) noexcept {
+   return static_cast<uint32_t>(range >> 32);
+}
+
+
+/// Start the worker threads                                                  
+///   @param workers - number of threads besides the calling one              
+WorkPool::WorkPool(uint32_t workers)
+   : mSlots {::std::make_unique<Slot[]>(workers + 1)} {
+   mThreads.reserve(workers);
+   for (uint32_t i = 0; i < workers; ++i)
+      mThreads.emplace_back(&WorkPool::Work, this, i + 1);
+}
+
+/// Stop and join the worker threads                                          
+WorkPool::~WorkPool() {
+   {
+      ::std::scoped_lock lock {mMutex};
+      mStop = true;
+   }
+   mWake.notify_all();
+   for (auto& thread : mThreads)
+      thread.join();
+}
+
+/// Get the default number of worker threads - one less than the hardware     
+/// threads, because the calling thread participates, too                     
+///   @return the number of workers                                           
+auto WorkPool::DefaultWorkers() noexcept -> uint32_t {
+   const auto hardware = ::std::thread::hardware_concurrency();
+   return hardware > 1 ? ::std::min(hardware - 1, 63u) : 0;
+}
+
+/// Run a job, and wait for all of its tasks to finish                        
+///   @param tasks - number of tasks                                          
+///   @param task - the task function                                         
+///   @param context - passed to the task function                            
+void WorkPool::Execute(uint32_t tasks, Task task, void* context) {
+   if (not tasks)
+      return;
+
+   ::std::unique_lock busy {mBusy, ::std::try_to_lock};
+   if (tasks == 1 or mThreads.empty() or not busy.owns_lock()) {
+      // Not worth waking anyone up, or the pool is already busy        
+      for (uint32_t i = 0; i < tasks; ++i)
+         task(context, i);
+      return;
+   }
+
+   // Split the tasks evenly between all participants                   
+   const auto participants = GetThreadCount();
+   for (uint32_t i = 0; i < participants; ++i) {
+      const auto begin = static_cast<uint32_t>(uint64_t {tasks} * i / participants);
+      const auto end = static_cast<uint32_t>(uint64_t {tasks} * (i + 1) / participants);
+      mSlots[i].mRange.store(PackRange(begin, end), ::std::memory_order_relaxed);
+   }
+
+   mTask = task;
+   mContext = context;
+   mActive.store(static_cast<uint32_t>(mThreads.size()), ::std::memory_order_relaxed);
+   {
+      ::std::scoped_lock lock {mMutex};
+      ++mGeneration;
+   }
+   mWake.notify_all();
+
+   // Participate, and wait for the workers to leave the job, so that   
+   // nothing refers to it after returning                              
+   Participate(0);
+   for (auto active = mActive.load(::std::memory_order_acquire); active;
+             active = mActive.load(::std::memory_order_acquire))
+      mActive.wait(active, ::std::memory_order_acquire);
+}
+
+/// Run tasks of the current job, until there's nothing left to steal         
+///   @param self - index of the participant's slot                           
+void WorkPool::Participate(uint32_t self) noexcept {
+   const auto participants = GetThreadCount();
+   auto& own = mSlots[self].mRange;
+
+   while (true) {
+      // Take tasks from the front of the own range                     
+      auto range = own.load(::std::memory_order_acquire);
+      while (RangeBegin(range) < RangeEnd(range)) {
+         const auto next = PackRange(RangeBegin(range) + 1, RangeEnd(range));
+         if (own.compare_exchange_weak(range, next, ::std::memory_order_acq_rel)) {
+            mTask(mContext, RangeBegin(range));
+            range = next;
+         }
+      }
+
+      // Steal the back half of someone else's range                    
+      bool stole = false;
+      for (uint32_t i = 1; i < participants and not stole; ++i) {
+         auto& victim = mSlots[(self + i) % participants].mRange;
+         auto theirs = victim.load(::std::memory_order_acquire);
+         while (RangeBegin(theirs) < RangeEnd(theirs)) {
+            const auto begin = RangeBegin(theirs);
+            const auto end = RangeEnd(theirs);
+            const auto split = end - (end - begin + 1) / 2;
+            if (victim.compare_exchange_weak(theirs, PackRange(begin, split), ::std::memory_order_acq_rel)) {
+               own.store(PackRange(split, end), ::std::memory_order_release);
+               stole = true;
+               break;
+            }
+         }
+      }
+
+      if (not stole)
+         return;
+   }
+}
+
+/// Worker thread routine                                                     
+///   @param self - index of the worker's slot                                
+void WorkPool::Work(uint32_t self) {
+   uint64_t seen = 0;
+   while (true) {
+      {
+         ::std::unique_lock lock {mMutex};
+         mWake.wait(lock, [&] {
+            return mStop or mGeneration != seen;
+         });
+         if (mStop)
+            return;
+         seen = mGeneration;
+      }
+
+      Participate(self);
+      if (mActive.fetch_sub(1, ::std::memory_order_acq_rel) == 1)
+         mActive.notify_all();
+   }
+}
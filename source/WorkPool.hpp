@@ -0,0 +1,84 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+///                                                                           
+///   Work-stealing thread pool                                               
+///                                                                           
+///   Runs a number of independent tasks in parallel, on a fixed set of       
+/// worker threads, and on the calling thread. Each participant starts with   
+/// an equal, contiguous range of tasks, and once it runs out, steals half of 
+/// the remaining range of another participant, so uneven tasks still keep    
+/// everyone busy. Ranges are packed in a single atomic word, so neither      
+/// taking nor stealing a task ever locks, and running a job never allocates. 
+///   Only one job runs at a time - if the pool is busy with another job, the 
+/// tasks simply run on the calling thread.                                   
+///                                                                           
+class WorkPool {
+public:
+   using Task = void(*)(void* context, uint32_t task);
+
+   explicit WorkPool(uint32_t workers = DefaultWorkers());
+   WorkPool(const WorkPool&) = delete;
+   ~WorkPool();
+
+   static auto DefaultWorkers() noexcept -> uint32_t;
+
+   /// Get the number of threads that participate in a job, including the     
+   /// calling one                                                            
+   uint32_t GetThreadCount() const noexcept {
+      return static_cast<uint32_t>(mThreads.size()) + 1;
+   }
+
+   /// Run tasks in parallel, and wait for all of them to finish              
+   ///   @param tasks - number of tasks                                       
+   ///   @param f - the task, invoked with the task index                     
+   template<class F>
+   void Run(uint32_t tasks, F&& f) {
+      Execute(tasks, [](void* context, uint32_t task) {
+         (*static_cast<::std::remove_reference_t<F>*>(context))(task);
+      }, const_cast<void*>(static_cast<const void*>(&f)));
+   }
+
+private:
+   void Execute(uint32_t, Task, void*);
+   void Participate(uint32_t) noexcept;
+   void Work(uint32_t);
+
+   /// Range of tasks of a participant, begin in the low, end in the high     
+   /// half - padded to avoid false sharing                                   
+   struct alignas(64) Slot {
+      ::std::atomic<uint64_t> mRange {0};
+   };
+
+   ::std::vector<::std::thread> mThreads;
+   ::std::unique_ptr<Slot[]> mSlots;
+
+   // Held while a job runs                                             
+   ::std::mutex mBusy;
+   // Wakes the workers up, for a new job, or for stopping              
+   ::std::mutex mMutex;
+   ::std::condition_variable mWake;
+   uint64_t mGeneration = 0;
+   bool mStop = false;
+   // Number of workers that haven't finished the current job           
+   ::std::atomic<uint32_t> mActive {0};
+
+   // The current job                                                   
+   Task mTask {};
+   void* mContext {};
+};
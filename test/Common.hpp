@@ -0,0 +1,30 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../source/Traits.hpp"
+#include <Langulus/Verbs/Select.hpp>
+#include <Langulus/Verbs/Associate.hpp>
+#include <Langulus/Testing.hpp>
+#include <string>
+
+
+/// Ask the GUI systems in a hierarchy for what they would've written to the  
+/// terminal on their last update - only headless systems answer              
+///   @param root - the hierarchy                                             
+///   @return the escape sequences and graphemes, or the whole screen as      
+///           text, if FTXUI had to redraw it                                 
+inline std::string Display(Thing& root) {
+   Verbs::Select query {MetaTraitOf<Traits::Display>()};
+   root.Run(query);
+
+   std::string output;
+   query.GetOutput().ForEachDeep([&](const Text& text) {
+      output += std::string {Token {text}};
+   });
+   return output;
+}
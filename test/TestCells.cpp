@@ -0,0 +1,101 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Cells.hpp"
+#include <Langulus/Testing.hpp>
+#include <string>
+
+
+SCENARIO("Cell buffer resizing", "[cells]") {
+   GIVEN("A cell buffer of 80x24 cells") {
+      CellBuffer cells;
+      cells.Resize(80, 24);
+      const auto glyphs = cells.mGlyphs.data();
+      const auto capacity = cells.mGlyphs.capacity();
+
+      REQUIRE(cells.GetCount() == 80 * 24);
+      REQUIRE(cells.mFg.size() == 80 * 24);
+      REQUIRE(cells.mBg.size() == 80 * 24);
+      REQUIRE(cells.mStyles.size() == 80 * 24);
+
+      WHEN("It shrinks, and grows back") {
+         cells.Resize(40, 12);
+         REQUIRE(cells.GetCount() == 40 * 12);
+         cells.Resize(80, 24);
+
+         THEN("Nothing is reallocated") {
+            REQUIRE(cells.mGlyphs.data() == glyphs);
+            REQUIRE(cells.mGlyphs.capacity() == capacity);
+         }
+      }
+
+      WHEN("It grows a column at a time, as when a terminal is dragged") {
+         uint32_t reallocations = 0;
+         auto data = cells.mGlyphs.data();
+         for (uint32_t width = 81; width <= 100; ++width) {
+            cells.Resize(width, 24);
+            if (cells.mGlyphs.data() != data) {
+               data = cells.mGlyphs.data();
+               ++reallocations;
+            }
+         }
+
+         THEN("Growth reallocates only once in a while") {
+            REQUIRE(cells.GetCount() == 100 * 24);
+            REQUIRE(reallocations <= 1);
+         }
+      }
+   }
+}
+
+SCENARIO("Glyph table recycling", "[cells]") {
+   GIVEN("A full glyph table, and cells that use two of its graphemes") {
+      GlyphTable table;
+      for (uint32_t i = table.GetCount(); i < GlyphTable::Capacity; ++i)
+         table.Intern("g" + std::to_string(i));
+      REQUIRE(table.GetCount() == GlyphTable::Capacity);
+
+      CellBuffer cells;
+      cells.Resize(4, 1);
+      cells.mGlyphs[0] = 'A';
+      cells.mGlyphs[1] = table.Intern("g1000");
+      cells.mGlyphs[2] = table.Intern("g60000");
+      cells.mGlyphs[3] = table.Intern("g1000");
+      const std::string_view cached = "g60000";
+      REQUIRE(table.Intern(cached) == cells.mGlyphs[2]);
+
+      WHEN("A new grapheme is interned") {
+         const auto id = table.Intern("new");
+
+         THEN("It's unknown, because the table is capped") {
+            REQUIRE(id == GlyphTable::Unknown);
+            REQUIRE(table.GetCount() == GlyphTable::Capacity);
+         }
+      }
+
+      WHEN("The table is recycled, keeping the graphemes of the cells") {
+         CellBuffer* used[] {&cells};
+         const auto dropped = table.Recycle(used);
+
+         THEN("Only the used graphemes remain, and new ones can be interned again") {
+            REQUIRE(dropped == GlyphTable::Capacity - 128 - 2);
+            REQUIRE(table.GetCount() == 130);
+            REQUIRE(table.Get(cells.mGlyphs[0]) == "A");
+            REQUIRE(table.Get(cells.mGlyphs[1]) == "g1000");
+            REQUIRE(table.Get(cells.mGlyphs[2]) == "g60000");
+            REQUIRE(cells.mGlyphs[3] == cells.mGlyphs[1]);
+            REQUIRE(table.Intern("g1000") == cells.mGlyphs[1]);
+            REQUIRE(table.Intern(cached) == cells.mGlyphs[2]);
+
+            const auto id = table.Intern("new");
+            REQUIRE(id != GlyphTable::Unknown);
+            REQUIRE(table.Get(id) == "new");
+            REQUIRE(table.Intern("g2000") != GlyphTable::Unknown);
+         }
+      }
+   }
+}
@@ -0,0 +1,224 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Console.hpp"
+#include <Langulus/Testing.hpp>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+
+/// A script that writes its step numbers                                     
+struct Counting final : Console::Script {
+   uint32_t mSteps;
+
+   Counting(uint32_t steps)
+      : mSteps {steps} {}
+
+   uint32_t GetSteps() const noexcept override {
+      return mSteps;
+   }
+
+   void Run(uint32_t step, Console& console) const override {
+      console.Write("step " + std::to_string(step));
+   }
+};
+
+/// A script that creates a child in a hierarchy on each step, and remembers  
+/// if any step ran on another thread than the one that updates it            
+struct Spawning final : Console::Script {
+   uint32_t mSteps;
+   std::function<void()> mSpawn;
+   std::thread::id mOwner;
+   std::atomic<int>* mForeign;
+   std::atomic<int>* mPrepared;
+
+   Spawning(uint32_t steps, std::function<void()> spawn,
+            std::atomic<int>* foreign, std::atomic<int>* prepared)
+      : mSteps {steps}, mSpawn {std::move(spawn)}
+      , mOwner {std::this_thread::get_id()}
+      , mForeign {foreign}, mPrepared {prepared} {}
+
+   void Prepare() override {
+      ++*mPrepared;
+      if (std::this_thread::get_id() != mOwner)
+         ++*mForeign;
+   }
+
+   uint32_t GetSteps() const noexcept override {
+      return mSteps;
+   }
+
+   void Run(uint32_t, Console&) const override {
+      if (std::this_thread::get_id() != mOwner)
+         ++*mForeign;
+      mSpawn();
+   }
+};
+
+/// Run the console's commands on this thread, until all are finished         
+void WaitFor(Console& console) {
+   const auto start = std::chrono::steady_clock::now();
+   while (console.IsBusy()) {
+      REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+      console.Execute(std::chrono::milliseconds(1));
+      std::this_thread::yield();
+   }
+}
+
+SCENARIO("Asynchronous console", "[console]") {
+   GIVEN("A console, whose commands are step counts") {
+      std::atomic<int> parses {0};
+      Console console {[&](std::string_view command) -> std::shared_ptr<Console::Script> {
+         ++parses;
+         if (command == "fail")
+            throw std::runtime_error("no such command");
+         return std::make_shared<Counting>(std::stoi(std::string {command}));
+      }};
+      LogRing log {1024, 64 * 1024};
+
+      WHEN("A command is submitted") {
+         console.Submit("3");
+         WaitFor(console);
+         console.Drain(log, 1000);
+
+         THEN("It's echoed, and its results are streamed back") {
+            REQUIRE(log.GetCount() == 4);
+            REQUIRE(log.Get(0).mText == "> 3");
+            REQUIRE(log.Get(0).mColor == Console::EchoColor);
+            REQUIRE(log.Get(1).mText == "step 0");
+            REQUIRE(log.Get(3).mText == "step 2");
+         }
+      }
+
+      WHEN("A command is submitted again") {
+         console.Submit("2");
+         console.Submit("5");
+         console.Submit("2");
+         WaitFor(console);
+
+         THEN("Its parse result is reused, and it moves to the front of the history") {
+            REQUIRE(parses == 2);
+            REQUIRE(console.GetStats().mParsed == 2);
+            REQUIRE(console.GetStats().mReused == 1);
+            std::string command;
+            REQUIRE(console.GetHistory(0, command));
+            REQUIRE(command == "2");
+            REQUIRE(console.GetHistory(1, command));
+            REQUIRE(command == "5");
+            REQUIRE_FALSE(console.GetHistory(2, command));
+         }
+      }
+
+      WHEN("More commands are run than the history holds") {
+         for (uint32_t i = 0; i < Console::HistorySize + 10; ++i)
+            console.Submit(std::to_string(i % 2 ? 1000 + i : i));
+         WaitFor(console);
+
+         THEN("Only the most recent ones are kept") {
+            std::string command;
+            REQUIRE(console.GetHistory(Console::HistorySize - 1, command));
+            REQUIRE_FALSE(console.GetHistory(Console::HistorySize, command));
+         }
+      }
+
+      WHEN("A command fails to parse") {
+         console.Submit("fail");
+         WaitFor(console);
+         console.Drain(log, 1000);
+
+         THEN("The error is streamed back") {
+            REQUIRE(log.GetCount() == 2);
+            REQUIRE(log.Get(1).mText == "no such command");
+            REQUIRE(log.Get(1).mColor == Console::ErrorColor);
+         }
+      }
+
+      WHEN("A command is submitted, but never executed") {
+         console.Submit("3");
+         while (not console.GetStats().mParsed)
+            std::this_thread::yield();
+         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+         console.Drain(log, 1000);
+
+         THEN("It's parsed, but none of its steps run") {
+            REQUIRE(console.IsBusy());
+            REQUIRE(log.GetCount() == 1);
+            REQUIRE(log.Get(0).mText == "> 3");
+         }
+      }
+
+      WHEN("A long command is executed within a budget") {
+         console.Submit("1000000");
+         while (not console.GetStats().mParsed)
+            std::this_thread::yield();
+         const auto ran = console.Execute(std::chrono::microseconds(100));
+
+         THEN("It runs only partially, and continues on the next call") {
+            REQUIRE(ran > 0);
+            REQUIRE(ran < 1000000);
+            REQUIRE(console.IsBusy());
+            REQUIRE(console.Execute(std::chrono::microseconds(100)) > 0);
+         }
+      }
+
+      WHEN("A running command is cancelled") {
+         console.Submit("1000000");
+         console.Submit("1");
+         while (console.GetStats().mParsed < 2)
+            std::this_thread::yield();
+         console.Execute(std::chrono::microseconds(100));
+         console.Cancel();
+         WaitFor(console);
+         console.Drain(log, 1000000);
+
+         THEN("It stops, and waiting commands are dropped") {
+            REQUIRE(console.GetStats().mCancelled == 1);
+            REQUIRE(log.Get(log.GetCount() - 1).mText == "Cancelled");
+            int firstSteps = 0;
+            for (uint32_t i = 0; i < log.GetCount(); ++i)
+               firstSteps += log.Get(i).mText == "step 0";
+            REQUIRE(firstSteps == 1);
+         }
+      }
+   }
+}
+
+SCENARIO("Console commands run between hierarchy updates", "[console]") {
+   GIVEN("A console, whose commands create children in a hierarchy") {
+      auto root = Thing::Root<false>("Console");
+      std::atomic<int> foreign {0};
+      std::atomic<int> prepared {0};
+      std::thread::id parser;
+      Console console {[&](std::string_view command) -> std::shared_ptr<Console::Script> {
+         parser = std::this_thread::get_id();
+         return std::make_shared<Spawning>(
+            static_cast<uint32_t>(std::stoi(std::string {command})),
+            [&] { root.CreateChild(); }, &foreign, &prepared);
+      }};
+
+      WHEN("A command runs, while the hierarchy is updated every frame") {
+         console.Submit("200");
+         const auto start = std::chrono::steady_clock::now();
+         while (console.IsBusy()) {
+            REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+            root.Update({});
+            console.Execute(std::chrono::microseconds(50));
+         }
+         root.Update({});
+
+         THEN("It's parsed on submission, and all steps run between updates") {
+            REQUIRE(parser == std::this_thread::get_id());
+            REQUIRE(prepared == 1);
+            REQUIRE(foreign == 0);
+            REQUIRE(root.GetChildren().GetCount() == 200);
+         }
+      }
+   }
+}
@@ -0,0 +1,194 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Common.hpp"
+#include <Langulus/Math/Color.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+/// Heap allocations made through the global operator new, while counting     
+/// The replacement is seen by the module, too, wherever the platform         
+/// resolves operator new across shared libraries. Containers of the          
+/// framework use its own allocator, so building and running verbs isn't      
+/// counted, but everything the module does with standard containers and      
+/// FTXUI is                                                                  
+static std::atomic<bool> counting {false};
+static std::atomic<size_t> allocations {0};
+
+void* operator new(std::size_t size) {
+   if (counting.load(std::memory_order_relaxed))
+      allocations.fetch_add(1, std::memory_order_relaxed);
+   if (auto p = std::malloc(size ? size : 1))
+      return p;
+   throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept {
+   std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+   std::free(p);
+}
+
+
+/// Draw a frame into the GUI systems of a hierarchy, through reflection,     
+/// the way a renderer module would, and update the hierarchy                 
+///   @param root - the hierarchy                                             
+///   @param size - size of the frame                                         
+///   @param channels - the cell channels                                     
+void DrawFrame(Thing& root, Scale2 size, const Many& channels) {
+   Many cells;
+   cells << Traits::Size {size} << channels;
+   Verbs::Associate associate {cells};
+   root.Run(associate);
+   root.Update({});
+}
+
+SCENARIO("Steady state frames, converted from colors", "[gui]") {
+   GIVEN("A headless GUI system, quantizing to a palette, and rendering on every update") {
+      constexpr uint32_t width = 120;
+      constexpr uint32_t height = 40;
+      auto root = Thing::Root<false>("FTXUI");
+      auto gui = root.CreateUnit<A::UISystem>(
+         Traits::Headless {true}, Traits::Size {Scale2 {width, height}},
+         Traits::Colors {256}, Traits::Dither {true},
+         Traits::KeepAlive {Time {}});
+      REQUIRE(gui.GetCount() == 1);
+
+      std::mt19937 rng {42};
+      std::uniform_real_distribution<float> unit {0.f, 1.f};
+      TMany<Math::RGBAf> fg, bg;
+      for (uint32_t i = 0; i < width * height; ++i) {
+         fg << Math::RGBAf {unit(rng), unit(rng), unit(rng), 1.f};
+         bg << Math::RGBAf {unit(rng), unit(rng), unit(rng), 1.f};
+      }
+
+      // Every other frame changes a color, so that some rows are       
+      // converted, encoded, and expanded to pixels again               
+      Many channels;
+      channels << Traits::CellForeground {fg} << Traits::CellBackground {bg};
+      const auto frame = [&](int i) {
+         bg[(i % height) * width] = Math::RGBAf {unit(rng), unit(rng), unit(rng), 1.f};
+         DrawFrame(root, Scale2 {width, height}, channels);
+      };
+
+      // Warm up - pooled images, caches and scratch storage are        
+      // filled by the first few frames                                 
+      for (int i = 0; i < 10; ++i)
+         frame(i);
+
+      WHEN("Many frames are drawn, converted, presented, and rendered") {
+         allocations = 0;
+         counting = true;
+         for (int i = 10; i < 110; ++i)
+            frame(i);
+         counting = false;
+
+         THEN("None of them allocate") {
+            REQUIRE(allocations == 0);
+         }
+      }
+   }
+}
+
+SCENARIO("Steady state frames, drawn as native cells", "[gui]") {
+   GIVEN("A headless GUI system, that renders on every update") {
+      constexpr uint32_t width = 40;
+      constexpr uint32_t height = 10;
+      auto root = Thing::Root<false>("FTXUI");
+      auto gui = root.CreateUnit<A::UISystem>(
+         Traits::Headless {true}, Traits::Size {Scale2 {width, height}},
+         Traits::KeepAlive {Time {}});
+      REQUIRE(gui.GetCount() == 1);
+
+      const uint32_t symbols[] {' ', '#', 0x2588, 0x2593, 0x2592};
+      TMany<uint32_t> glyphs, fg, bg;
+      for (uint32_t i = 0; i < width * height; ++i) {
+         glyphs << symbols[i % std::size(symbols)];
+         fg << 0xFFFFFFu;
+         bg << (i * 2654435761u) % 0xFFFFFFu;
+      }
+
+      // Every frame changes a cell, so that it's encoded and written   
+      Many channels;
+      channels << Traits::CellGlyphs {glyphs}
+               << Traits::CellForeground {fg}
+               << Traits::CellBackground {bg};
+      const auto frame = [&](int i) {
+         glyphs[static_cast<uint32_t>(i) % (width * height)] = symbols[i % std::size(symbols)];
+         DrawFrame(root, Scale2 {width, height}, channels);
+      };
+
+      for (int i = 0; i < 10; ++i)
+         frame(i);
+
+      WHEN("Many frames are drawn, presented, and rendered") {
+         allocations = 0;
+         counting = true;
+         for (int i = 10; i < 110; ++i)
+            frame(i);
+         counting = false;
+
+         THEN("None of them allocate") {
+            REQUIRE(allocations == 0);
+         }
+      }
+   }
+}
+
+SCENARIO("Steady state frames, with the editor shown", "[gui]") {
+   GIVEN("A headless GUI system with the editor, that renders on every update") {
+      constexpr uint32_t width = 80;
+      constexpr uint32_t height = 24;
+      auto root = Thing::Root<false>("FTXUI");
+      auto gui = root.CreateUnit<A::UISystem>(
+         Traits::Headless {true}, Traits::Size {Scale2 {width, height}},
+         Traits::Editor {true}, Traits::KeepAlive {Time {}});
+      REQUIRE(gui.GetCount() == 1);
+      for (int i = 0; i < 8; ++i)
+         root.CreateChild();
+
+      TMany<uint32_t> glyphs, fg, bg;
+      for (uint32_t i = 0; i < width * height; ++i) {
+         glyphs << uint32_t {'#'};
+         fg << 0xFFFFFFu;
+         bg << 0u;
+      }
+
+      Many channels;
+      channels << Traits::CellGlyphs {glyphs}
+               << Traits::CellForeground {fg}
+               << Traits::CellBackground {bg};
+      const auto frames = [&](int count) {
+         allocations = 0;
+         counting = true;
+         for (int i = 0; i < count; ++i)
+            DrawFrame(root, Scale2 {width, height}, channels);
+         counting = false;
+         return allocations.load();
+      };
+
+      // Warm up - the mirror of the hierarchy, the log, and the tree   
+      // are filled by the first few frames                             
+      frames(10);
+
+      WHEN("Many identical frames are drawn, presented, and rendered") {
+         const auto first = frames(100);
+         const auto second = frames(100);
+
+         THEN("The editor's storage doesn't grow") {
+            // FTXUI builds a new element tree on every render, so the  
+            // editor can't render without allocating - but nothing it  
+            // keeps across frames may keep growing                     
+            REQUIRE(second <= first);
+         }
+      }
+   }
+}
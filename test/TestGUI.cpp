@@ -5,8 +5,9 @@
 ///                                                                           
 /// SPDX-License-Identifier: GPL-3.0-or-later                                 
 ///                                                                           
-#include <Langulus/UI.hpp>
-#include <Langulus/Testing.hpp>
+#include "Common.hpp"
+#include <thread>
+#include <vector>
 
 
 SCENARIO("GUI creation", "[gui]") {
@@ -30,6 +31,52 @@ SCENARIO("GUI creation", "[gui]") {
             REQUIRE(root.GetUnits().GetCount() == 1);
          }
 
+         WHEN("A headless GUI system is created") {
+            auto gui = root.CreateUnit<A::UISystem>(
+               Traits::Headless {true}, Traits::Size {Scale2 {40, 10}});
+
+            // Update a few times, without any terminal attached        
+            for (int i = 0; i < 3; ++i)
+               root.Update({});
+            root.DumpHierarchy();
+
+            REQUIRE(gui.GetCount() == 1);
+            REQUIRE(gui.CastsTo<A::UISystem>(1));
+            REQUIRE(gui.IsSparse());
+            REQUIRE(root.GetUnits().GetCount() == 1);
+         }
+
+         WHEN("A headless GUI system is created with the editor") {
+            auto gui = root.CreateUnit<A::UISystem>(
+               Traits::Headless {true}, Traits::Size {Scale2 {80, 24}},
+               Traits::Editor {true});
+            Logger::Info("Logged into the editor");
+
+            // The log is drained, when the editor is rendered          
+            for (int i = 0; i < 3; ++i)
+               root.Update({});
+
+            REQUIRE(gui.GetCount() == 1);
+            REQUIRE(Display(root).find("Logged into the editor") != std::string::npos);
+         }
+
+         WHEN("A child is added under a headless GUI system with the editor") {
+            auto gui = root.CreateUnit<A::UISystem>(
+               Traits::Headless {true}, Traits::Size {Scale2 {80, 24}},
+               Traits::Editor {true});
+            root.Update({});
+            REQUIRE(Display(root).find("Probe") == std::string::npos);
+
+            // The editor mirrors the change on the next update, and    
+            // the tree shows it on the next frame                      
+            root.CreateChild(Traits::Name {"Probe"});
+            for (int i = 0; i < 3; ++i)
+               root.Update({});
+
+            REQUIRE(gui.GetCount() == 1);
+            REQUIRE(Display(root).find("Probe") != std::string::npos);
+         }
+
       #if LANGULUS_FEATURE(MANAGED_REFLECTION)
          WHEN("The GUI system is created via tokens") {
             auto gui = root.CreateUnitToken("GUISystem");
@@ -56,6 +103,30 @@ SCENARIO("GUI creation", "[gui]") {
             REQUIRE(gui.IsSparse());
             REQUIRE(root.GetUnits().GetCount() == 1);
          }
+
+         WHEN("Widgets are created in a headless GUI system") {
+            auto gui = root.CreateUnit<A::UISystem>(
+               Traits::Headless {true}, Traits::Size {Scale2 {40, 10}});
+            auto label = root.CreateUnitToken("GUIItem",
+               Traits::Caption {"Status"});
+            auto gauge = root.CreateUnitToken("GUIItem",
+               Traits::Widget {"gauge"}, Traits::Caption {"Load"},
+               Traits::Progress {0.5});
+            auto table = root.CreateUnitToken("GUIItem",
+               Traits::Widget {"table"}, Traits::Caption {"Name\tValue\nFPS\t60"});
+
+            // Update a few times, so that widgets are built and retained
+            for (int i = 0; i < 3; ++i)
+               root.Update({});
+            root.DumpHierarchy();
+
+            REQUIRE(gui.GetCount() == 1);
+            REQUIRE(label.GetCount() == 1);
+            REQUIRE(gauge.GetCount() == 1);
+            REQUIRE(table.GetCount() == 1);
+            REQUIRE(label.CastsTo<A::UIUnit>(1));
+            REQUIRE(root.GetUnits().GetCount() == 4);
+         }
       #endif
 
          // Check for memory leaks after each cycle                     
@@ -64,3 +135,237 @@ SCENARIO("GUI creation", "[gui]") {
    }
 }
 
+
+/// Put text into a row of code points                                        
+///   @param glyphs - the code points                                         
+///   @param text - ASCII text for the row                                    
+void Row(TMany<uint32_t>& glyphs, std::string_view text) {
+   for (auto c : text)
+      glyphs << static_cast<uint32_t>(c);
+}
+
+SCENARIO("Drawing cells through reflection", "[gui]") {
+   GIVEN("A headless GUI system") {
+      auto root = Thing::Root<false>("FTXUI");
+      auto gui = root.CreateUnit<A::UISystem>(
+         Traits::Headless {true}, Traits::Size {Scale2 {8, 2}});
+      REQUIRE(gui.GetCount() == 1);
+
+      WHEN("Its native format is queried") {
+         Verbs::Select query {MetaTraitOf<Traits::CellFormat>()};
+         root.Run(query);
+
+         Scale2 size;
+         query.GetOutput().ForEachDeep([&](const Scale2& s) {
+            size = s;
+         });
+
+         THEN("Frames of its size are taken") {
+            REQUIRE(size == Scale2 {8, 2});
+         }
+      }
+
+      WHEN("Cells are associated, and presented twice") {
+         const auto draw = [&](std::string_view top) {
+            TMany<uint32_t> glyphs, fg, bg;
+            Row(glyphs, top);
+            glyphs << 0x2588u;
+            Row(glyphs, "       ");
+            for (int i = 0; i < 16; ++i) {
+               fg << 0xFFFFFFu;
+               bg << 0u;
+            }
+
+            Many cells;
+            cells << Traits::Size {Scale2 {8, 2}}
+                  << Traits::CellGlyphs {glyphs}
+                  << Traits::CellForeground {fg}
+                  << Traits::CellBackground {bg};
+            Verbs::Associate associate {cells};
+            root.Run(associate);
+            root.Update({});
+            return Display(root);
+         };
+
+         const auto first = draw("Hi there");
+         const auto second = draw("Hi world");
+
+         THEN("The first frame is drawn whole, and the second only where it changed") {
+            REQUIRE(first.find("Hi there") != std::string::npos);
+            REQUIRE(first.find("█") != std::string::npos);
+            REQUIRE(second.find("world") != std::string::npos);
+            REQUIRE(second.find("Hi") == std::string::npos);
+            REQUIRE(second.find("█") == std::string::npos);
+         }
+      }
+
+      WHEN("Cells with code points that aren't characters are associated") {
+         TMany<uint32_t> glyphs, fg, bg;
+         Row(glyphs, "Bad");
+         glyphs << 0xD800u << 0x110000u;
+         Row(glyphs, "   ");
+         Row(glyphs, "        ");
+         for (int i = 0; i < 16; ++i) {
+            fg << 0xFFFFFFu;
+            bg << 0u;
+         }
+
+         Many cells;
+         cells << Traits::Size {Scale2 {8, 2}}
+               << Traits::CellGlyphs {glyphs}
+               << Traits::CellForeground {fg}
+               << Traits::CellBackground {bg};
+         Verbs::Associate associate {cells};
+         root.Run(associate);
+         root.Update({});
+         const auto shown = Display(root);
+
+         THEN("They are shown as replacement characters") {
+            REQUIRE(shown.find("Bad��") != std::string::npos);
+         }
+      }
+   }
+}
+
+SCENARIO("Changing the traits of widgets", "[gui]") {
+   GIVEN("Two labels in a headless GUI system, one of them in a child") {
+      auto root = Thing::Root<false>("FTXUI");
+      auto gui = root.CreateUnit<A::UISystem>(
+         Traits::Headless {true}, Traits::Size {Scale2 {40, 10}});
+      root.CreateUnitToken("GUIItem", Traits::Caption {"Unchanging"});
+      auto child = root.CreateChild();
+      child->CreateUnitToken("GUIItem", Traits::Caption {"Before"});
+
+      root.Update({});
+      const auto first = Display(root);
+      REQUIRE(first.find("Unchanging") != std::string::npos);
+      REQUIRE(first.find("Before") != std::string::npos);
+
+      // Settle, so that only changes are presented from now on         
+      for (int i = 0; i < 3; ++i)
+         root.Update({});
+
+      WHEN("The caption of the child's label is associated anew") {
+         Verbs::Associate associate {Traits::Caption {"Latter"}};
+         child->Run(associate);
+         root.Update({});
+         const auto second = Display(root);
+
+         THEN("Only that label is rebuilt and presented again") {
+            REQUIRE(second.find("Latter") != std::string::npos);
+            REQUIRE(second.find("Before") == std::string::npos);
+            REQUIRE(second.find("Unchanging") == std::string::npos);
+         }
+      }
+
+      WHEN("Nothing is associated") {
+         root.Update({});
+
+         THEN("Nothing is presented again") {
+            REQUIRE(Display(root).find("Unchanging") == std::string::npos);
+            REQUIRE(Display(root).find("Before") == std::string::npos);
+         }
+      }
+   }
+}
+
+SCENARIO("Resizing the terminal", "[gui]") {
+   GIVEN("A headless GUI system that is rarely kept alive") {
+      auto root = Thing::Root<false>("FTXUI");
+      auto gui = root.CreateUnit<A::UISystem>(
+         Traits::Headless {true}, Traits::Size {Scale2 {40, 10}},
+         Traits::KeepAlive {Time {std::chrono::hours {1}}});
+      root.Update({});
+
+      const auto query = [&](auto&& trait) {
+         Verbs::Select select {trait};
+         root.Run(select);
+         Scale2 size;
+         select.GetOutput().ForEachDeep([&](const Scale2& s) {
+            size = s;
+         });
+         return size;
+      };
+
+      const auto events = [&] {
+         Verbs::Select select {MetaTraitOf<Traits::InputEvents>()};
+         root.Run(select);
+         uint64_t max {};
+         select.GetOutput().ForEachDeep([&](const TMany<uint64_t>& s) {
+            max = s[2];
+         });
+         return max;
+      };
+
+      WHEN("The terminal is resized, and updated without any time passing") {
+         Verbs::Associate associate {Traits::Size {Scale2 {60, 20}}};
+         root.Run(associate);
+         root.Update({});
+
+         THEN("Frames are drawn at the new size, but the resize isn't reported yet") {
+            REQUIRE(query(MetaTraitOf<Traits::CellFormat>()) == Scale2 {60, 20});
+            REQUIRE(query(MetaTraitOf<Traits::Size>()) == Scale2 {40, 10});
+            REQUIRE(events() == 0);
+         }
+
+         WHEN("The size settles") {
+            std::this_thread::sleep_for(std::chrono::milliseconds {150});
+            root.Update({});
+
+            THEN("The resize is delivered, even though no time was given") {
+               REQUIRE(query(MetaTraitOf<Traits::Size>()) == Scale2 {60, 20});
+               REQUIRE(events() == 1);
+            }
+         }
+      }
+   }
+}
+
+SCENARIO("Following the hierarchy in the editor", "[gui]") {
+   GIVEN("A headless GUI system with the editor, over a few levels of Things") {
+      auto root = Thing::Root<false>("FTXUI");
+      auto gui = root.CreateUnit<A::UISystem>(
+         Traits::Headless {true}, Traits::Size {Scale2 {120, 40}},
+         Traits::Editor {true});
+      auto child = root.CreateChild(Traits::Name {"Child"});
+      auto grandchild = child->CreateChild(Traits::Name {"Inner"});
+      for (int i = 0; i < 3; ++i)
+         root.Update({});
+
+      const auto search = [&](const char* query) {
+         Verbs::Select select {Traits::Search {Text {query}}};
+         root.Run(select);
+         std::vector<std::string> labels;
+         select.GetOutput().ForEachDeep([&](const Text& label) {
+            labels.push_back(std::string {Token {label}});
+         });
+         return labels;
+      };
+
+      REQUIRE(search("Inner") == std::vector<std::string> {"Inner"});
+
+      WHEN("A grandchild is renamed, and gets a child of its own") {
+         // Neither is reported to the editor, which sweeps for them    
+         grandchild->SetName("Renamed");
+         grandchild->CreateChild(Traits::Name {"Deepest"});
+         for (int i = 0; i < 3; ++i)
+            root.Update({});
+
+         THEN("The index has both, by their current names only") {
+            REQUIRE(search("Inner").empty());
+            REQUIRE(search("Renamed") == std::vector<std::string> {"Renamed"});
+            REQUIRE(search("Deepest") == std::vector<std::string> {"Deepest"});
+         }
+
+         THEN("The tree shows both, once the new child is revealed") {
+            Verbs::Associate reveal {Traits::Search {Text {"Deepest"}}};
+            root.Run(reveal);
+            root.Update({});
+
+            const auto shown = Display(root);
+            REQUIRE(shown.find("Renamed") != std::string::npos);
+            REQUIRE(shown.find("Deepest") != std::string::npos);
+         }
+      }
+   }
+}
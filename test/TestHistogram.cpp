@@ -0,0 +1,87 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Histogram.hpp"
+#include <Langulus/Testing.hpp>
+#include <thread>
+#include <vector>
+
+
+SCENARIO("Rolling histogram", "[stats]") {
+   GIVEN("Bucket boundaries") {
+      THEN("Every value falls in the bucket it bounds") {
+         for (uint32_t i = 0; i + 1 < Histogram::Buckets; ++i) {
+            const auto lower = Histogram::LowerBound(i);
+            REQUIRE(Histogram::BucketOf(lower) == i);
+            REQUIRE(Histogram::BucketOf(Histogram::LowerBound(i + 1) - 1) == i);
+         }
+         REQUIRE(Histogram::BucketOf(UINT64_MAX) == Histogram::Buckets - 1);
+      }
+   }
+
+   GIVEN("A histogram with a window of 1000 samples") {
+      Histogram histogram {1000};
+
+      WHEN("Samples from 1 to 1000 are recorded") {
+         for (uint64_t i = 1; i <= 1000; ++i)
+            histogram.Record(i);
+         const auto snapshot = histogram.GetSnapshot();
+
+         THEN("The summary describes them, within bucket precision") {
+            REQUIRE(snapshot.mCount == 1000);
+            REQUIRE(snapshot.mMin == 1);
+            REQUIRE(snapshot.mMax == 1000);
+            REQUIRE(snapshot.Mean() == 500);
+            REQUIRE(snapshot.Percentile(50) >= 500 * 3 / 4);
+            REQUIRE(snapshot.Percentile(50) <= 500);
+            REQUIRE(snapshot.Percentile(99) >= 990 * 3 / 4);
+            REQUIRE(snapshot.Percentile(100) <= 1000);
+         }
+      }
+
+      WHEN("Many more samples than the window are recorded") {
+         for (int i = 0; i < 10000; ++i)
+            histogram.Record(1);
+         for (int i = 0; i < 2000; ++i)
+            histogram.Record(100);
+
+         THEN("Only the last one to two windows are described") {
+            const auto snapshot = histogram.GetSnapshot();
+            REQUIRE(snapshot.mCount >= 1000);
+            REQUIRE(snapshot.mCount <= 2000);
+            REQUIRE(snapshot.mMin == 100);
+         }
+      }
+
+      WHEN("Samples are recorded from several threads") {
+         std::vector<std::thread> threads;
+         for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&histogram] {
+               for (int i = 0; i < 250; ++i)
+                  histogram.Record(42);
+            });
+         }
+         for (auto& thread : threads)
+            thread.join();
+
+         THEN("None are lost within a window") {
+            const auto snapshot = histogram.GetSnapshot();
+            REQUIRE(snapshot.mCount == 1000);
+            REQUIRE(snapshot.mSum == 42000);
+         }
+      }
+
+      WHEN("Nothing is recorded") {
+         THEN("The summary is all zeroes") {
+            const auto snapshot = histogram.GetSnapshot();
+            REQUIRE(snapshot.mCount == 0);
+            REQUIRE(snapshot.mMin == 0);
+            REQUIRE(snapshot.Percentile(50) == 0);
+         }
+      }
+   }
+}
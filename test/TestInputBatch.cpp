@@ -0,0 +1,176 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/InputBatch.hpp"
+#include <Langulus/Testing.hpp>
+
+
+/// Make a pointer event                                                      
+InputEvent Pointer(InputEvent::Kind kind, int x, int y, int delta = 0) {
+   InputEvent event;
+   event.mKind = kind;
+   event.mX = x;
+   event.mY = y;
+   event.mDelta = delta;
+   return event;
+}
+
+SCENARIO("Input batching", "[input]") {
+   GIVEN("An input batch") {
+      InputBatch batch;
+      std::vector<InputEvent> taken;
+
+      WHEN("Nothing is pushed") {
+         THEN("Nothing is taken") {
+            REQUIRE_FALSE(batch.Take(taken));
+            REQUIRE(taken.empty());
+         }
+      }
+
+      WHEN("A burst of pointer motion and scrolling is pushed") {
+         for (int i = 0; i < 100; ++i) {
+            batch.Push(Pointer(InputEvent::MouseMove, i, 2 * i));
+            batch.Push(Pointer(InputEvent::Scroll, i, i, -1));
+         }
+         batch.Take(taken);
+
+         THEN("One event of each kind remains, with the latest state") {
+            REQUIRE(taken.size() == 2);
+            REQUIRE(taken[0].mKind == InputEvent::MouseMove);
+            REQUIRE(taken[0].mX == 99);
+            REQUIRE(taken[0].mY == 198);
+            REQUIRE(taken[1].mKind == InputEvent::Scroll);
+            REQUIRE(taken[1].mDelta == -100);
+            REQUIRE(batch.GetStats().mPushed == 200);
+            REQUIRE(batch.GetStats().mCoalesced == 198);
+         }
+      }
+
+      WHEN("Keys and buttons are pushed between pointer motion") {
+         InputEvent key;
+         key.mKind = InputEvent::Key;
+         key.mKey = InputEvent::Return;
+         auto press = Pointer(InputEvent::MouseButton, 5, 5);
+         press.mPressed = true;
+
+         batch.Push(Pointer(InputEvent::MouseMove, 1, 1));
+         batch.Push(key);
+         batch.Push(press);
+         batch.Push(key);
+         batch.Push(Pointer(InputEvent::MouseMove, 9, 9));
+         batch.Take(taken);
+
+         THEN("Nothing is coalesced across them, and all keep their order") {
+            REQUIRE(taken.size() == 5);
+            REQUIRE(taken[0].mKind == InputEvent::MouseMove);
+            REQUIRE(taken[0].mX == 1);
+            REQUIRE(taken[1].mKind == InputEvent::Key);
+            REQUIRE(taken[2].mKind == InputEvent::MouseButton);
+            REQUIRE(taken[2].mPressed);
+            REQUIRE(taken[3].mKind == InputEvent::Key);
+            REQUIRE(taken[4].mKind == InputEvent::MouseMove);
+            REQUIRE(taken[4].mX == 9);
+            REQUIRE(batch.GetStats().mCoalesced == 0);
+         }
+      }
+
+      WHEN("Pointer motion bursts surround a click") {
+         auto press = Pointer(InputEvent::MouseButton, 5, 5);
+         press.mPressed = true;
+         auto release = press;
+         release.mPressed = false;
+
+         for (int i = 0; i <= 5; ++i)
+            batch.Push(Pointer(InputEvent::MouseMove, i, i));
+         batch.Push(press);
+         batch.Push(release);
+         for (int i = 6; i <= 9; ++i)
+            batch.Push(Pointer(InputEvent::MouseMove, i, i));
+         batch.Take(taken);
+
+         THEN("Each burst is coalesced on its side of the click") {
+            REQUIRE(taken.size() == 4);
+            REQUIRE(taken[0].mKind == InputEvent::MouseMove);
+            REQUIRE(taken[0].mX == 5);
+            REQUIRE(taken[1].mKind == InputEvent::MouseButton);
+            REQUIRE(taken[1].mPressed);
+            REQUIRE(taken[2].mKind == InputEvent::MouseButton);
+            REQUIRE_FALSE(taken[2].mPressed);
+            REQUIRE(taken[3].mKind == InputEvent::MouseMove);
+            REQUIRE(taken[3].mX == 9);
+            REQUIRE(batch.GetStats().mCoalesced == 8);
+         }
+      }
+
+      WHEN("A drag is reported, as terminals report it") {
+         // Older FTXUI reports dragging as repeated presses, newer as  
+         // motion of the pressed button                                
+         for (auto report : {MouseButtons::Pressed, MouseButtons::Moved}) {
+            MouseButtons buttons;
+            const auto translate = [&](MouseButtons::Report what, int x) {
+               auto event = Pointer(InputEvent::MouseButton, x, x);
+               buttons.Translate(InputEvent::ButtonLeft, what, event);
+               batch.Push(event);
+            };
+
+            translate(MouseButtons::Pressed, 0);
+            for (int i = 1; i < 10; ++i)
+               translate(report, i);
+            translate(MouseButtons::Released, 10);
+
+            auto hover = Pointer(InputEvent::MouseMove, 11, 11);
+            buttons.Move(hover);
+            batch.Push(hover);
+            batch.Take(taken);
+
+            REQUIRE(taken.size() == 4);
+            REQUIRE(taken[0].mKind == InputEvent::MouseButton);
+            REQUIRE(taken[0].mPressed);
+            REQUIRE(taken[1].mKind == InputEvent::MouseMove);
+            REQUIRE(taken[1].mX == 9);
+            REQUIRE(taken[1].mButtons == 1 << InputEvent::ButtonLeft);
+            REQUIRE(taken[2].mKind == InputEvent::MouseButton);
+            REQUIRE_FALSE(taken[2].mPressed);
+            REQUIRE(taken[2].mButtons == 0);
+            REQUIRE(taken[3].mKind == InputEvent::MouseMove);
+            REQUIRE(taken[3].mButtons == 0);
+         }
+
+         THEN("Only the press and the release are button events, and the motion between them is coalesced") {
+            REQUIRE(batch.GetStats().mPushed == 24);
+            REQUIRE(batch.GetStats().mCoalesced == 16);
+         }
+      }
+
+      WHEN("Scrolling changes direction") {
+         batch.Push(Pointer(InputEvent::Scroll, 0, 0, 1));
+         batch.Push(Pointer(InputEvent::Scroll, 0, 0, 1));
+         batch.Push(Pointer(InputEvent::Scroll, 0, 0, -1));
+         batch.Take(taken);
+
+         THEN("Each direction is accumulated separately") {
+            REQUIRE(taken.size() == 2);
+            REQUIRE(taken[0].mDelta == 2);
+            REQUIRE(taken[1].mDelta == -1);
+         }
+      }
+
+      WHEN("Batches are taken one after another") {
+         batch.Push(Pointer(InputEvent::Resize, 80, 24));
+         batch.Take(taken);
+         batch.Push(Pointer(InputEvent::Resize, 120, 40));
+         batch.Push(Pointer(InputEvent::Resize, 100, 30));
+         batch.Take(taken);
+
+         THEN("Each batch is coalesced on its own") {
+            REQUIRE(taken.size() == 1);
+            REQUIRE(taken[0].mX == 100);
+            REQUIRE(batch.GetStats().mBatches == 2);
+         }
+      }
+   }
+}
@@ -0,0 +1,147 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Kernels.hpp"
+#include <Langulus/Testing.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+SCENARIO("Color conversion kernels", "[kernels]") {
+   // Values that are known to be troublesome for vector kernels        
+   const float special[] {
+      0.f, -0.f, 1.f, -1.f, 2.f, 0.5f, 0.999999f, 1e-7f, 0.392f, 0.6117f,
+      NAN, INFINITY, -INFINITY
+   };
+
+   std::mt19937 rng {42};
+   std::uniform_real_distribution<float> unit {-0.25f, 1.25f};
+
+   const auto kernels = Kernels::GetConvertKernels();
+   REQUIRE(not kernels.empty());
+
+   for (uint32_t count = 0; count < 70; ++count) {
+      GIVEN(std::string("A row of ") + std::to_string(count) + " pixels") {
+         std::vector<float> rgba(count * 4);
+         for (auto& c : rgba) {
+            c = rng() % 4 == 0
+               ? special[rng() % std::size(special)]
+               : unit(rng);
+         }
+
+         std::vector<Kernels::RGB8> bg(count), fg(count);
+         Kernels::ConvertScalar(rgba.data(), count, bg.data(), fg.data());
+
+         for (auto& kernel : kernels) {
+            WHEN(std::string("Converted with the ") + kernel.mName + " kernel") {
+               std::vector<Kernels::RGB8> bg2(count, 0xFFFFFFFF);
+               std::vector<Kernels::RGB8> fg2(count, 0xFFFFFFFF);
+               kernel.mFunction(rgba.data(), count, bg2.data(), fg2.data());
+
+               THEN("The results match the scalar kernel bit-for-bit") {
+                  REQUIRE(bg2 == bg);
+                  REQUIRE(fg2 == fg);
+               }
+            }
+
+            WHEN(std::string("Converted with the ") + kernel.mName + " kernel, without shades") {
+               std::vector<Kernels::RGB8> bg2(count, 0xFFFFFFFF);
+               kernel.mFunction(rgba.data(), count, bg2.data(), nullptr);
+
+               THEN("The colors match the scalar kernel bit-for-bit") {
+                  REQUIRE(bg2 == bg);
+               }
+            }
+         }
+      }
+   }
+
+   GIVEN("Pure black, white and middle grey") {
+      const float rgba[] {
+         0.f, 0.f, 0.f, 1.f,
+         1.f, 1.f, 1.f, 1.f,
+         0.5f, 0.5f, 0.5f, 1.f
+      };
+
+      Kernels::RGB8 bg[3], fg[3];
+      Kernels::GetConvertKernel().mFunction(rgba, 3, bg, fg);
+
+      THEN("Foreground shades contrast with the background") {
+         REQUIRE(bg[0] == Kernels::Pack(0, 0, 0));
+         REQUIRE(fg[0] == Kernels::Pack(255, 255, 255));
+         REQUIRE(bg[1] == Kernels::Pack(255, 255, 255));
+         REQUIRE(fg[1] == Kernels::Pack(0, 0, 0));
+         REQUIRE(bg[2] == Kernels::Pack(127, 127, 127));
+         REQUIRE(fg[2] == Kernels::Pack(27, 27, 27));
+      }
+   }
+
+   GIVEN("A row of colors in range") {
+      std::uniform_real_distribution<float> inRange {0.f, 1.f};
+      std::vector<float> rgba(4096 * 4);
+      for (auto& c : rgba)
+         c = inRange(rng);
+
+      for (auto& kernel : kernels) {
+         WHEN(std::string("Converted with the ") + kernel.mName + " kernel") {
+            std::vector<Kernels::RGB8> bg(4096), fg(4096);
+            kernel.mFunction(rgba.data(), 4096, bg.data(), fg.data());
+
+            THEN("Shades are exactly those of the original per-pixel formula") {
+               for (uint32_t i = 0; i < 4096; ++i) {
+                  const float* c = &rgba[i * 4];
+                  auto shade = static_cast<uint8_t>(255 - (c[0] * 0.299 + c[1] * 0.587 + c[2] * 0.114) * 255);
+                  if (shade >= 100 and shade <= 156)
+                     shade -= 100;
+                  REQUIRE(fg[i] == Kernels::Pack(shade, shade, shade));
+               }
+            }
+         }
+      }
+   }
+}
+
+SCENARIO("Flag translation kernels", "[kernels]") {
+   // Every bit moves somewhere else, or gets dropped                   
+   const int moves[8] {0, 1, 2, 3, 5, 6, -1, 7};
+   uint8_t table[256] {};
+   for (int f = 0; f < 256; ++f) {
+      for (int bit = 0; bit < 8; ++bit) {
+         if ((f & (1 << bit)) and moves[bit] >= 0)
+            table[f] |= static_cast<uint8_t>(1 << moves[bit]);
+      }
+   }
+
+   std::mt19937 rng {42};
+   const auto kernels = Kernels::GetTranslateKernels();
+   REQUIRE(not kernels.empty());
+
+   for (uint32_t count : {0u, 1u, 31u, 32u, 33u, 100u, 400u}) {
+      GIVEN(std::string("A row of ") + std::to_string(count) + " flags") {
+         std::vector<uint8_t> flags(count);
+         for (auto& f : flags)
+            f = static_cast<uint8_t>(rng());
+
+         std::vector<uint8_t> expected(count);
+         Kernels::TranslateScalar(flags.data(), count, table, expected.data());
+         for (uint32_t i = 0; i < count; ++i)
+            REQUIRE(expected[i] == table[flags[i]]);
+
+         for (auto& kernel : kernels) {
+            WHEN(std::string("Translated with the ") + kernel.mName + " kernel") {
+               std::vector<uint8_t> out(count, 0xAA);
+               kernel.mFunction(flags.data(), count, table, out.data());
+
+               THEN("The results match the scalar kernel bit-for-bit") {
+                  REQUIRE(out == expected);
+               }
+            }
+         }
+      }
+   }
+}
@@ -0,0 +1,126 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/LogQueue.hpp"
+#include <Langulus/Testing.hpp>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+SCENARIO("Lock-free log queue", "[log]") {
+   GIVEN("A queue of 64 fragments, and a log") {
+      LogQueue queue {64};
+      LogRing log {1024, 64 * 1024};
+
+      WHEN("Lines are pushed in several fragments") {
+         queue.Push(LogQueue::Style, {}, Kernels::Pack(255, 0, 0), 1);
+         queue.Push(LogQueue::Text, "hello, ");
+         queue.Push(LogQueue::Text, "world");
+         queue.Push(LogQueue::NewLine);
+         queue.Push(LogQueue::Text, "unfinished");
+
+         THEN("Only finished lines reach the log, with their style") {
+            REQUIRE(queue.Drain(log, 100) == 5);
+            REQUIRE(log.GetCount() == 1);
+            REQUIRE(log.Get(0).mText == "hello, world");
+            REQUIRE(log.Get(0).mColor == Kernels::Pack(255, 0, 0));
+            REQUIRE(log.Get(0).mStyle == 1);
+         }
+      }
+
+      WHEN("Text longer than a fragment is pushed") {
+         const std::string text(LogQueue::InlineText * 3 + 5, 'x');
+         queue.Push(LogQueue::Text, text);
+         queue.Push(LogQueue::NewLine);
+         queue.Drain(log, 100);
+
+         THEN("It's split, and reassembled") {
+            REQUIRE(log.GetCount() == 1);
+            REQUIRE(log.Get(0).mText == text);
+            REQUIRE(queue.GetStats().mPushed == 5);
+         }
+      }
+
+      WHEN("More fragments are pushed than the queue can hold") {
+         for (int i = 0; i < 100; ++i)
+            queue.Push(LogQueue::NewLine);
+
+         THEN("The rest are dropped, and counted") {
+            REQUIRE(queue.GetStats().mPushed == 64);
+            REQUIRE(queue.GetStats().mDropped == 36);
+            REQUIRE(queue.Drain(log, 1000) == 64);
+            REQUIRE(log.GetCount() == 64);
+            REQUIRE(queue.GetStats().mPeakBatch == 64);
+         }
+      }
+
+      WHEN("Fewer fragments than available are drained") {
+         for (int i = 0; i < 10; ++i)
+            queue.Push(LogQueue::NewLine);
+
+         THEN("The rest stay in the queue for the next batch") {
+            REQUIRE(queue.Drain(log, 4) == 4);
+            REQUIRE(queue.Drain(log, 100) == 6);
+            REQUIRE(queue.Drain(log, 100) == 0);
+         }
+      }
+
+      WHEN("The log is cleared through the queue") {
+         queue.Push(LogQueue::Text, "line");
+         queue.Push(LogQueue::NewLine);
+         queue.Push(LogQueue::Clear);
+         queue.Drain(log, 100);
+
+         THEN("It's empty") {
+            REQUIRE(log.GetCount() == 0);
+         }
+      }
+   }
+
+   GIVEN("Several threads logging at once, while the log is drained") {
+      constexpr int Threads = 4;
+      constexpr int Lines = 2000;
+      LogQueue queue {256};
+      LogRing log {Threads * Lines, 1024 * 1024};
+
+      std::vector<std::thread> producers;
+      for (int t = 0; t < Threads; ++t) {
+         producers.emplace_back([&queue, t] {
+            for (int i = 0; i < Lines; ++i) {
+               const auto number = std::to_string(i);
+               while (not queue.Push(LogQueue::Text, std::to_string(t) + ":"))
+                  std::this_thread::yield();
+               while (not queue.Push(LogQueue::Text, number))
+                  std::this_thread::yield();
+               while (not queue.Push(LogQueue::NewLine))
+                  std::this_thread::yield();
+            }
+         });
+      }
+
+      uint64_t drained = 0;
+      while (drained < Threads * Lines * 3)
+         drained += queue.Drain(log, 64);
+      for (auto& producer : producers)
+         producer.join();
+
+      THEN("Every line arrives intact, and in order for each thread") {
+         REQUIRE(log.GetCount() == Threads * Lines);
+         std::map<std::string, int> next;
+         for (uint32_t i = 0; i < log.GetCount(); ++i) {
+            const std::string line {log.Get(i).mText};
+            const auto colon = line.find(':');
+            REQUIRE(colon != std::string::npos);
+            const auto thread = line.substr(0, colon);
+            REQUIRE(line.substr(colon + 1) == std::to_string(next[thread]++));
+         }
+         REQUIRE(next.size() == Threads);
+      }
+   }
+}
@@ -0,0 +1,77 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/LogRing.hpp"
+#include <Langulus/Testing.hpp>
+#include <string>
+
+
+SCENARIO("Bounded log", "[log]") {
+   GIVEN("A log of 8 lines and 64 bytes") {
+      LogRing log {8, 64};
+
+      WHEN("Fewer lines than it can hold are pushed") {
+         log.Push("first", Kernels::Pack(255, 0, 0), 1);
+         log.Push("second", Kernels::Pack(0, 255, 0));
+
+         THEN("All of them are kept, oldest first") {
+            REQUIRE(log.GetCount() == 2);
+            REQUIRE(log.Get(0).mText == "first");
+            REQUIRE(log.Get(0).mColor == Kernels::Pack(255, 0, 0));
+            REQUIRE(log.Get(0).mStyle == 1);
+            REQUIRE(log.Get(1).mText == "second");
+         }
+      }
+
+      WHEN("More lines than it can hold are pushed") {
+         for (int i = 0; i < 100; ++i)
+            log.Push(std::to_string(i), 0);
+
+         THEN("Only the most recent ones are kept") {
+            REQUIRE(log.GetCount() == 8);
+            REQUIRE(log.GetPushed() == 100);
+            for (uint32_t i = 0; i < 8; ++i)
+               REQUIRE(log.Get(i).mText == std::to_string(92 + i));
+         }
+      }
+
+      WHEN("More text than it can hold is pushed") {
+         for (int i = 0; i < 100; ++i)
+            log.Push(std::string(5 + i % 11, static_cast<char>('a' + i % 26)), 0);
+
+         THEN("Kept lines are intact, and fit in the text buffer") {
+            REQUIRE(log.GetCount() > 0);
+            uint32_t bytes = 0;
+            for (uint32_t i = 0; i < log.GetCount(); ++i) {
+               const int index = 100 - log.GetCount() + i;
+               const auto line = log.Get(i).mText;
+               REQUIRE(line == std::string(5 + index % 11, static_cast<char>('a' + index % 26)));
+               bytes += static_cast<uint32_t>(line.size());
+            }
+            REQUIRE(bytes <= 64);
+         }
+      }
+
+      WHEN("A line longer than a quarter of the text buffer is pushed") {
+         log.Push(std::string(100, 'x'), 0);
+
+         THEN("It gets truncated") {
+            REQUIRE(log.GetCount() == 1);
+            REQUIRE(log.Get(0).mText == std::string(16, 'x'));
+         }
+      }
+
+      WHEN("The log is cleared") {
+         log.Push("line", 0);
+         log.Clear();
+
+         THEN("It's empty") {
+            REQUIRE(log.GetCount() == 0);
+         }
+      }
+   }
+}
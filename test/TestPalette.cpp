@@ -0,0 +1,97 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/Palette.hpp"
+#include <Langulus/Testing.hpp>
+#include <set>
+#include <vector>
+
+using namespace Kernels;
+
+
+SCENARIO("Palette quantization", "[palette]") {
+   GIVEN("A truecolor quantizer") {
+      Palette palette;
+      std::vector<RGB8> row {Pack(1, 2, 3), Pack(255, 128, 0)};
+      const auto original = row;
+      palette.Quantize(row.data(), 2, 0);
+
+      THEN("Colors remain untouched") {
+         REQUIRE(row == original);
+      }
+   }
+
+   for (auto depth : {ColorDepth::Colors256, ColorDepth::Colors16}) {
+      const auto flag = depth == ColorDepth::Colors256 ? Indexed256 : Indexed16;
+      const std::string colors = depth == ColorDepth::Colors256 ? "256" : "16";
+
+      GIVEN("A " + colors + " color quantizer") {
+         Palette palette {depth};
+         constexpr auto Step = 256 / Palette::Levels;
+
+         WHEN("The center of each lookup table cell is quantized") {
+            std::vector<RGB8> row, expected;
+            for (uint32_t b = Step / 2; b < 256; b += Step) {
+               for (uint32_t g = Step / 2; g < 256; g += Step) {
+                  for (uint32_t r = Step / 2; r < 256; r += Step) {
+                     row.push_back(Pack(r, g, b));
+                     expected.push_back(flag | Palette::Nearest(depth, row.back()));
+                  }
+               }
+            }
+            palette.Quantize(row.data(), static_cast<uint32_t>(row.size()), 0);
+
+            THEN("The lookup table matches an exhaustive search") {
+               REQUIRE(row == expected);
+            }
+         }
+
+         WHEN("Primary colors are quantized") {
+            RGB8 row[] {Pack(0, 0, 0), Pack(255, 255, 255), Pack(255, 0, 0)};
+            palette.Quantize(row, 3, 0);
+
+            THEN("They map to the same colors in the palette") {
+               REQUIRE(Palette::GetColor(row[0]) == Pack(0, 0, 0));
+               REQUIRE(Palette::GetColor(row[1]) == Pack(255, 255, 255));
+               REQUIRE(Palette::GetColor(row[2]) == Pack(255, 0, 0));
+            }
+         }
+      }
+
+      GIVEN("A dithered " + colors + " color quantizer") {
+         Palette plain {depth};
+         Palette dithered {depth, true};
+         REQUIRE(dithered.GetSeed() != plain.GetSeed());
+
+         WHEN("A flat area in between palette colors is quantized") {
+            const auto color = Pack(150, 150, 150);
+            std::set<RGB8> plainColors, ditheredColors;
+            uint32_t sum = 0;
+            for (uint32_t y = 0; y < 4; ++y) {
+               RGB8 a[4] {color, color, color, color};
+               RGB8 b[4] {color, color, color, color};
+               plain.Quantize(a, 4, y);
+               dithered.Quantize(b, 4, y);
+               for (int x = 0; x < 4; ++x) {
+                  REQUIRE(PaletteOf(b[x]) == flag);
+                  plainColors.insert(a[x]);
+                  ditheredColors.insert(b[x]);
+                  sum += Red(Palette::GetColor(b[x]));
+               }
+            }
+
+            THEN("Dithering mixes neighboring colors to approximate it") {
+               REQUIRE(plainColors.size() == 1);
+               REQUIRE(ditheredColors.size() > 1);
+               const auto plainError = std::abs(Red(Palette::GetColor(*plainColors.begin())) - 150);
+               const auto ditheredError = std::abs(static_cast<int>(sum / 16) - 150);
+               REQUIRE(ditheredError < plainError);
+            }
+         }
+      }
+   }
+}
@@ -0,0 +1,124 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/SearchIndex.hpp"
+#include <Langulus/Testing.hpp>
+#include <string>
+#include <vector>
+
+
+SCENARIO("Hierarchy search index", "[search]") {
+   GIVEN("An index of 100k objects, half of them sharing a type") {
+      constexpr int Count = 100000;
+      std::vector<int> objects(Count);
+      SearchIndex index;
+      index.Begin();
+      for (int i = 0; i < Count; ++i) {
+         const auto term = i % 2 ? std::string {"A::Renderable"} : "Entity" + std::to_string(i);
+         index.Touch(&objects[i], i ? &objects[0] : nullptr, term, i % 2);
+      }
+      REQUIRE(index.Sweep() == 0);
+      REQUIRE(index.GetCount() == Count);
+
+      std::vector<uint32_t> found;
+
+      WHEN("Searching for a unique name, in a different case") {
+         const auto total = index.Find("ENTITY4242", found, 100);
+
+         THEN("Only objects containing it are found") {
+            // Entity4242, and Entity42420 to Entity42428               
+            REQUIRE(total == 6);
+            REQUIRE(found.size() == 6);
+            for (auto entry : found)
+               REQUIRE(index.GetTerm(entry).find("Entity4242") == 0);
+         }
+      }
+
+      WHEN("Searching for a shared type") {
+         const auto total = index.Find("render", found, 100);
+
+         THEN("All are counted, but only as many as asked are collected") {
+            REQUIRE(total == Count / 2);
+            REQUIRE(found.size() == 100);
+            REQUIRE(index.Get(found[0]).mKind == 1);
+            REQUIRE(index.Get(found[0]).mParent == &objects[0]);
+         }
+      }
+
+      WHEN("Searching for a query shorter than a trigram") {
+         const auto total = index.Find("y9", found, Count);
+
+         THEN("Terms are scanned instead") {
+            // Even numbers beginning with 9, up to five digits         
+            REQUIRE(total == 5 + 50 + 500 + 5000);
+         }
+      }
+
+      WHEN("Searching for something that isn't there") {
+         THEN("Nothing is found") {
+            REQUIRE(index.Find("missing", found, 100) == 0);
+            REQUIRE(found.empty());
+         }
+      }
+
+      WHEN("Objects are renamed or removed, and the index reconciled") {
+         index.Begin();
+         for (int i = 0; i < Count; ++i) {
+            if (i == 10)
+               index.Touch(&objects[i], &objects[0], "Renamed", 0);
+            else if (i % 1000)
+               index.Touch(&objects[i], &objects[0], i % 2 ? std::string {"A::Renderable"} : "Entity" + std::to_string(i), i % 2);
+         }
+
+         THEN("Only changed objects are affected") {
+            REQUIRE(index.Sweep() == Count / 1000);
+            REQUIRE(index.GetCount() == Count - Count / 1000);
+            REQUIRE(index.Find("renamed", found, 100) == 1);
+            REQUIRE(index.GetTerm(found[0]) == "Renamed");
+            REQUIRE(index.Find("Entity10", found, 1000) == 556 - 3);
+            REQUIRE(index.Find("Entity99000", found, 100) == 0);
+            REQUIRE(index.FindEntry(&objects[1000]) == nullptr);
+            REQUIRE(index.FindEntry(&objects[1001]) != nullptr);
+         }
+      }
+
+      WHEN("Uniquely named objects are removed") {
+         for (int i = 0; i < Count; i += 2)
+            REQUIRE(index.Remove(&objects[i]));
+
+         THEN("Their terms are released, and never found again") {
+            REQUIRE(index.GetCount() == Count / 2);
+            REQUIRE(index.GetTermCount() == 1);
+            REQUIRE(index.Find("entity", found, 100) == 0);
+            REQUIRE(index.Find("y9", found, 100) == 0);
+            REQUIRE(index.Find("render", found, 100) == Count / 2);
+            REQUIRE(index.FindEntry(&objects[2]) == nullptr);
+            REQUIRE_FALSE(index.Remove(&objects[2]));
+         }
+      }
+
+      WHEN("Objects keep coming back under new names") {
+         for (int round = 0; round < 10; ++round) {
+            for (int i = 0; i < Count; i += 2) {
+               index.Remove(&objects[i]);
+               index.Touch(&objects[i], &objects[0], "Round" + std::to_string(round) + "_" + std::to_string(i), 0);
+            }
+         }
+
+         THEN("Only the latest names are indexed and found") {
+            REQUIRE(index.GetCount() == Count);
+            REQUIRE(index.GetTermCount() == Count / 2 + 1);
+            REQUIRE(index.Find("entity", found, 100) == 0);
+            REQUIRE(index.Find("round3_", found, 100) == 0);
+            REQUIRE(index.Find("Round9_42", found, 1000) == 556);
+            for (auto entry : found)
+               REQUIRE(index.GetTerm(entry).find("Round9_42") == 0);
+            REQUIRE(index.Find("render", found, 100) == Count / 2);
+         }
+      }
+   }
+}
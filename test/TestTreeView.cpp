@@ -0,0 +1,127 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/TreeView.hpp"
+#include <Langulus/Testing.hpp>
+#include <string>
+#include <vector>
+
+
+/// A hierarchy to mirror - every item has a name, and children               
+struct Item {
+   std::string mName;
+   std::vector<Item*> mChildren;
+};
+
+SCENARIO("Lazy tree view", "[tree]") {
+   GIVEN("A hierarchy of 100 items with 100 children each") {
+      std::vector<Item> top(100);
+      std::vector<Item> leaves(100 * 100);
+      Item root;
+      for (int i = 0; i < 100; ++i) {
+         top[i].mName = "item" + std::to_string(i);
+         for (int j = 0; j < 100; ++j) {
+            auto& leaf = leaves[i * 100 + j];
+            leaf.mName = "leaf" + std::to_string(j);
+            top[i].mChildren.push_back(&leaf);
+         }
+         root.mChildren.push_back(&top[i]);
+      }
+
+      int populated = 0;
+      TreeView tree {[&](TreeView& view, uint32_t index) {
+         ++populated;
+         const auto* item = index == TreeView::Root
+            ? &root : static_cast<const Item*>(view.Get(index).mKey);
+         std::vector<TreeView::Child> children;
+         for (auto child : item->mChildren)
+            children.push_back({child, child->mName, 0, not child->mChildren.empty()});
+         view.Sync(index, children);
+      }};
+
+      WHEN("Rows are requested") {
+         const auto& rows = tree.GetRows();
+
+         THEN("Only the top items are created") {
+            REQUIRE(populated == 1);
+            REQUIRE(rows.size() == 100);
+            REQUIRE(tree.GetNodeCount() == 101);
+            REQUIRE(tree.Get(rows[5]).mLabel == "item5");
+            REQUIRE(tree.Get(rows[5]).mExpandable);
+         }
+      }
+
+      WHEN("An item is expanded") {
+         const auto item = tree.GetRows()[5];
+         tree.Expand(item, true);
+         const auto& rows = tree.GetRows();
+
+         THEN("Its children are created, and shown right below it") {
+            REQUIRE(populated == 2);
+            REQUIRE(rows.size() == 200);
+            REQUIRE(tree.Get(rows[6]).mLabel == "leaf0");
+            REQUIRE(tree.Get(rows[6]).mDepth == 2);
+            REQUIRE(tree.Get(rows[105]).mLabel == "leaf99");
+            REQUIRE(tree.Get(rows[106]).mLabel == "item6");
+         }
+
+         AND_WHEN("It is collapsed, and expanded again") {
+            tree.Expand(item, false);
+            REQUIRE(tree.GetRows().size() == 100);
+            tree.Expand(item, true);
+
+            THEN("Children are not created again") {
+               REQUIRE(populated == 2);
+               REQUIRE(tree.GetRows().size() == 200);
+            }
+         }
+      }
+
+      WHEN("A deep node is revealed") {
+         const TreeView::Key path[] {&top[42], &leaves[42 * 100 + 7]};
+         const auto node = tree.Reveal(path);
+         const auto& rows = tree.GetRows();
+
+         THEN("Only the nodes on the way to it are populated, and expanded") {
+            REQUIRE(populated == 2);
+            REQUIRE(tree.Get(node).mKey == &leaves[42 * 100 + 7]);
+            REQUIRE(rows.size() == 200);
+            REQUIRE(rows[42 + 1 + 7] == node);
+         }
+      }
+
+      WHEN("A path that doesn't exist is revealed") {
+         const TreeView::Key path[] {&top[42], &leaves[0]};
+
+         THEN("The root is returned") {
+            REQUIRE(tree.Reveal(path) == TreeView::Root);
+         }
+      }
+
+      WHEN("The hierarchy changes, and the tree is refreshed") {
+         tree.Expand(tree.GetRows()[0], true);
+         tree.Expand(tree.GetRows()[1], true);
+         const auto expanded = tree.GetRows()[0];
+
+         root.mChildren.erase(root.mChildren.begin() + 1);
+         top[0].mChildren.push_back(&leaves[100]);
+         top[0].mName = "renamed";
+         tree.Refresh();
+         const auto& rows = tree.GetRows();
+
+         THEN("Nodes that still exist are kept, along with their state") {
+            REQUIRE(rows.size() == 99 + 101);
+            REQUIRE(rows[0] == expanded);
+            REQUIRE(tree.Get(rows[0]).mLabel == "renamed");
+            REQUIRE(tree.Get(rows[0]).mExpanded);
+            REQUIRE(tree.Get(rows[101]).mLabel == "leaf0");
+            REQUIRE(tree.Get(rows[102]).mLabel == "item2");
+            REQUIRE(tree.GetNodeCount() == 1 + 99 + 101);
+         }
+      }
+   }
+}
@@ -0,0 +1,78 @@
+///                                                                           
+/// Langulus::Module::FTXUI                                                   
+/// Copyright (c) 2023 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../source/WorkPool.hpp"
+#include "../source/Cells.hpp"
+#include <Langulus/Testing.hpp>
+#include <string>
+
+
+SCENARIO("Work-stealing thread pool", "[pool]") {
+   for (uint32_t workers : {0u, 1u, 3u, 7u}) {
+      GIVEN(std::string("A pool with ") + std::to_string(workers) + " workers") {
+         WorkPool pool {workers};
+         REQUIRE(pool.GetThreadCount() == workers + 1);
+
+         WHEN("Jobs of different sizes are run") {
+            for (uint32_t tasks : {0u, 1u, 2u, 5u, 64u, 1000u}) {
+               std::vector<std::atomic<uint32_t>> runs(tasks);
+               pool.Run(tasks, [&](uint32_t task) {
+                  runs[task].fetch_add(1);
+               });
+
+               THEN("Each task runs exactly once") {
+                  for (auto& count : runs)
+                     REQUIRE(count.load() == 1);
+               }
+            }
+         }
+
+         WHEN("Tasks take very different times") {
+            std::atomic<uint64_t> sum {0};
+            pool.Run(100, [&](uint32_t task) {
+               // Only the first tasks are slow, so the rest get stolen 
+               uint64_t local = 0;
+               const auto work = task < 4 ? 2'000'000u : 10u;
+               for (uint32_t i = 0; i < work; ++i)
+                  local += i % 7;
+               sum.fetch_add(local + task);
+            });
+
+            THEN("All of them still finish") {
+               uint64_t expected = 0;
+               for (uint32_t task = 0; task < 100; ++task) {
+                  uint64_t local = 0;
+                  const auto work = task < 4 ? 2'000'000u : 10u;
+                  for (uint32_t i = 0; i < work; ++i)
+                     local += i % 7;
+                  expected += local + task;
+               }
+               REQUIRE(sum.load() == expected);
+            }
+         }
+
+         WHEN("Graphemes are interned from all threads, each with its own cache") {
+            GlyphTable table;
+            const std::string symbols[] {"█", "▓", "▒", "░", "│", "─", "┼", "a"};
+            std::vector<GlyphID> ids(8 * 64);
+            pool.Run(64, [&](uint32_t task) {
+               GlyphTable::Cache cache;
+               for (uint32_t i = 0; i < 8; ++i)
+                  ids[task * 8 + i] = table.Intern(symbols[(task + i) % 8], cache);
+            });
+
+            THEN("Each grapheme gets a single identifier") {
+               REQUIRE(table.GetCount() == 128 + 7);
+               for (uint32_t task = 0; task < 64; ++task) {
+                  for (uint32_t i = 0; i < 8; ++i)
+                     REQUIRE(table.Get(ids[task * 8 + i]) == symbols[(task + i) % 8]);
+               }
+            }
+         }
+      }
+   }
+}